@@ -0,0 +1,417 @@
+/*
+ ******************************************************************************
+ *  benchmark.cpp
+ *
+ *  Host benchmarks of DuinoMemory smart pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Times construction, copy, move, destruction and factory throughput of
+ *    U_ptr and S_ptr against std::unique_ptr and std::shared_ptr, and counts
+ *    heap allocations. Absolute numbers only make sense on the host; use
+ *    them to compare DuinoMemory versions and pointer flavors. The SpscQueue
+ *    hand-off runs a producer thread against the main thread and checks that
+ *    every object arrives, in order. The cycle collection run churns pooled
+ *    objects through U_ptr and S_ptr and checks that all are reclaimed. Run
+ *    with CXXFLAGS="-O2 -DDUINOMEMORY_TLSF_SIZE=65536" in the environment to
+ *    route the factories through the Tlsf allocator.
+ *
+ ******************************************************************************
+ */
+#include <DuinoMemory.hpp>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+
+HostSerial Serial;
+
+namespace
+{
+    size_t allocations = 0;
+    size_t iterations = 1000000;
+
+    struct Payload
+    {
+        uint32_t words[4];
+    };
+
+    struct Intrusive : DuinoMemory::RefCounted<>
+    {
+        uint32_t words[4];
+    };
+
+    // Second is not at the start of Both: deleting through it must still
+    // free the whole object.
+    struct First
+    {
+        uint32_t words[4];
+        virtual ~First(void) = default;
+    };
+
+    struct Second
+    {
+        uint32_t word;
+        virtual ~Second(void) = default;
+    };
+
+    struct Both : First, Second
+    {
+    };
+
+    struct Counted
+    {
+    };
+
+    struct Unlocked
+    {
+    };
+
+    struct Atomic
+    {
+    };
+
+    struct Linked;
+}
+
+namespace DuinoMemory
+{
+    template<>
+    struct SharedTraits<Counted> : DefaultSharedTraits
+    {
+        using count_type = uint8_t;
+    };
+
+    template<>
+    struct SharedTraits<Unlocked> : DefaultSharedTraits
+    {
+        using lock_type = NoLock;
+    };
+
+    template<>
+    struct SharedTraits<Atomic> : DefaultSharedTraits
+    {
+        using lock_type = AtomicLock;
+    };
+
+    template<>
+    struct SharedTraits<Linked> : DefaultSharedTraits
+    {
+        using lock_type = Collected<>;
+    };
+}
+
+namespace
+{
+    struct Linked
+    {
+        DuinoMemory::S_ptr<Linked> next;
+
+        template<typename Visitor>
+        void trace(Visitor& visit)
+        {
+            visit(next);
+        }
+    };
+}
+
+namespace
+{
+    // Prevents the compiler from optimizing value away.
+    template<typename T>
+    void keep(const T& value)
+    {
+        __asm__ volatile ("" : : "g" (&value) : "memory");
+    }
+
+    /**
+     * Runs body once per iteration and prints the time and allocations
+     * it takes per operation.
+     */
+    template<typename Body>
+    void measure(const char* name, Body body)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        for (size_t i = 0; i < iterations / 10; i++)
+        {
+            body();
+        }
+
+        auto allocations_before = allocations;
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            body();
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        printf("%-42s %9.2f ns/op %6.2f allocs/op\n", name, elapsed / iterations,
+            static_cast<double>(allocations - allocations_before) / iterations);
+    }
+
+    void factories(void)
+    {
+        printf("\n-- Factories (create + destroy) --\n");
+        measure("DuinoMemory::make_unique", [] { auto p = DuinoMemory::make_unique<Payload>(); keep(p); });
+        measure("std::unique_ptr(new)", [] { std::unique_ptr<Payload> p{ new Payload{ } }; keep(p); });
+        measure("DuinoMemory::make_shared", [] { auto p = DuinoMemory::make_shared<Payload>(); keep(p); });
+        measure("std::make_shared", [] { auto p = std::make_shared<Payload>(); keep(p); });
+        measure("DuinoMemory::S_ptr(new)", [] { DuinoMemory::S_ptr<Payload> p{ new Payload{ } }; keep(p); });
+        measure("std::shared_ptr(new)", [] { std::shared_ptr<Payload> p{ new Payload{ } }; keep(p); });
+        measure("DuinoMemory::make_intrusive", [] { auto p = DuinoMemory::make_intrusive<Intrusive>(); keep(p); });
+        measure("DuinoMemory::make_unique<int[]>(16)", [] { auto p = DuinoMemory::make_unique<int[]>(16); keep(p); });
+        measure("DuinoMemory::make_shared<int[]>(16)", [] { auto p = DuinoMemory::make_shared<int[]>(16); keep(p); });
+        measure("DuinoMemory::make_unique<const Payload>", [] { auto p = DuinoMemory::make_unique<const Payload>(); keep(p); });
+        measure("DuinoMemory::make_shared<const Payload>", [] { auto p = DuinoMemory::make_shared<const Payload>(); keep(p); });
+        measure("DuinoMemory::make_unique<Second, Both>", [] { auto p = DuinoMemory::make_unique<Second, Both>(); keep(p); });
+        measure("DuinoMemory::make_shared<Second, Both>", [] { auto p = DuinoMemory::make_shared<Second, Both>(); keep(p); });
+
+        static DuinoMemory::ObjectPool<Payload, 4> pool;
+        measure("DuinoMemory::make_pooled", [] { auto p = DuinoMemory::make_pooled<Payload>(pool); keep(p); });
+        measure("DuinoMemory::make_pooled_shared", [] { auto p = DuinoMemory::make_pooled_shared<Payload>(pool); keep(p); });
+
+        static uint8_t buffer[256];
+        static DuinoMemory::Arena arena{ buffer, sizeof(buffer) };
+        measure("DuinoMemory::make_unique_in + reset", [] { { auto p = DuinoMemory::make_unique_in<Payload>(arena); keep(p); } arena.reset(); });
+        measure("DuinoMemory::make_shared_in + reset", [] { { auto p = DuinoMemory::make_shared_in<Payload>(arena); keep(p); } arena.reset(); });
+
+        static DuinoMemory::SlotMap<Payload, 4> slots;
+        measure("DuinoMemory::SlotMap insert + erase", [] { auto h = slots.insert(); keep(h); slots.erase(h); });
+
+#if defined(DUINOMEMORY_TLSF_SIZE)
+        if (DuinoMemory::default_heap().used() != 0)
+        {
+            printf("factories left %zu bytes of the heap in use\n", DuinoMemory::default_heap().used());
+            abort();
+        }
+#endif
+    }
+
+    void copies(void)
+    {
+        printf("\n-- Copy + destroy of a shared pointer --\n");
+        auto shared = DuinoMemory::make_shared<Payload>();
+        measure("S_ptr (InterruptLock)", [&] { auto copy = shared; keep(copy); });
+
+        auto counted = DuinoMemory::make_shared<Counted>();
+        measure("S_ptr (uint8_t count)", [&] { auto copy = counted; keep(copy); });
+
+        auto unlocked = DuinoMemory::make_shared<Unlocked>();
+        measure("S_ptr (NoLock)", [&] { auto copy = unlocked; keep(copy); });
+
+        auto atomic = DuinoMemory::make_shared<Atomic>();
+        measure("S_ptr (AtomicLock)", [&] { auto copy = atomic; keep(copy); });
+
+        auto intrusive = DuinoMemory::make_intrusive<Intrusive>();
+        measure("I_ptr (InterruptLock)", [&] { auto copy = intrusive; keep(copy); });
+
+        auto standard = std::make_shared<Payload>();
+        measure("std::shared_ptr", [&] { auto copy = standard; keep(copy); });
+
+        uint8_t bytes[64] = { };
+        auto buffer = DuinoMemory::make_buf(bytes, sizeof(bytes));
+        measure("S_buf::slice", [&] { auto slice = buffer.slice(16, 32); keep(slice); });
+
+        DuinoMemory::W_ptr<Payload> weak = shared;
+        measure("W_ptr::lock", [&] { auto locked = weak.lock(); keep(locked); });
+
+        std::weak_ptr<Payload> standard_weak = standard;
+        measure("std::weak_ptr::lock", [&] { auto locked = standard_weak.lock(); keep(locked); });
+    }
+
+    void moves(void)
+    {
+        printf("\n-- Move back and forth --\n");
+        auto unique = DuinoMemory::make_unique<Payload>();
+        DuinoMemory::U_ptr<Payload> unique_other;
+        measure("U_ptr", [&] { unique_other = DuinoMemory::move(unique); keep(unique_other); unique = DuinoMemory::move(unique_other); keep(unique); });
+
+        std::unique_ptr<Payload> standard_unique{ new Payload{ } };
+        std::unique_ptr<Payload> standard_unique_other;
+        measure("std::unique_ptr", [&] { standard_unique_other = std::move(standard_unique); keep(standard_unique_other); standard_unique = std::move(standard_unique_other); keep(standard_unique); });
+
+        auto shared = DuinoMemory::make_shared<Payload>();
+        DuinoMemory::S_ptr<Payload> shared_other;
+        measure("S_ptr", [&] { shared_other = DuinoMemory::move(shared); keep(shared_other); shared = DuinoMemory::move(shared_other); keep(shared); });
+
+        auto standard_shared = std::make_shared<Payload>();
+        std::shared_ptr<Payload> standard_shared_other;
+        measure("std::shared_ptr", [&] { standard_shared_other = std::move(standard_shared); keep(standard_shared_other); standard_shared = std::move(standard_shared_other); keep(standard_shared); });
+    }
+
+    void handoff(void)
+    {
+        printf("\n-- SpscQueue hand-off between two threads --\n");
+
+        // Objects circulate between the queues: no allocation once filled.
+        static DuinoMemory::SpscQueue<Payload, 64> free_items;
+        static DuinoMemory::SpscQueue<Payload, 64> ready_items;
+        for (size_t i = 0; i < free_items.capacity(); i++)
+        {
+            free_items.push(DuinoMemory::make_unique<Payload>());
+        }
+
+        // On a single core, each batch costs a context switch: the numbers
+        // are meaningless and a full run would take ages.
+        static size_t count = iterations;
+        if (std::thread::hardware_concurrency() < 2)
+        {
+            count = iterations / 100;
+            printf("(single core host, %zu items only)\n", count);
+        }
+
+        auto allocations_before = allocations;
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread producer{ [] {
+            for (uint32_t sequence = 0; sequence < count; )
+            {
+                auto item = free_items.pop();
+                if (item)
+                {
+                    item->words[0] = sequence++;
+                    ready_items.push(DuinoMemory::move(item));
+                }
+            }
+        } };
+
+        for (uint32_t expected = 0; expected < count; )
+        {
+            auto item = ready_items.pop();
+            if (item)
+            {
+                if (item->words[0] != expected++)
+                {
+                    printf("SpscQueue delivered %u instead of %u\n", static_cast<unsigned>(item->words[0]), static_cast<unsigned>(expected - 1));
+                    abort();
+                }
+                free_items.push(DuinoMemory::move(item));
+            }
+        }
+
+        producer.join();
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        printf("%-42s %9.2f ns/op %6.2f allocs/op\n", "push + pop (in order)", elapsed / count,
+            static_cast<double>(allocations - allocations_before) / count);
+    }
+
+    void allocators(void)
+    {
+        printf("\n-- Allocate + free on a fragmented heap --\n");
+
+        // Keeps every other block of mixed sizes alive, so that the free
+        // space is split into many holes.
+        static const size_t sizes[] = { 12, 40, 24, 96, 16, 200, 64, 32 };
+        static DuinoMemory::Tlsf<32768> tlsf;
+        static void* kept[2][256];
+        for (size_t i = 0; i < 256; i++)
+        {
+            kept[0][i] = tlsf.allocate(sizes[i % 8]);
+            tlsf.deallocate(tlsf.allocate(sizes[(i + 3) % 8]));
+            kept[1][i] = malloc(sizes[i % 8]);
+            free(malloc(sizes[(i + 3) % 8]));
+        }
+
+        static size_t next = 0;
+        measure("Tlsf", [] { auto memory = tlsf.allocate(sizes[next++ % 8]); keep(memory); tlsf.deallocate(memory); });
+        measure("malloc", [] { auto memory = malloc(sizes[next++ % 8]); keep(memory); free(memory); });
+
+        for (size_t i = 0; i < 256; i++)
+        {
+            tlsf.deallocate(kept[0][i]);
+            free(kept[1][i]);
+        }
+    }
+
+    void cycles(void)
+    {
+        printf("\n-- Cycle collection of pooled objects --\n");
+
+        // U_ptr slots are never examined; S_ptr pairs leak as cycles.
+        static DuinoMemory::ObjectPool<Linked, 8> pool;
+        measure("make_pooled + pair cycle + collect_cycles", [] {
+            auto unique = DuinoMemory::make_pooled<Linked>(pool);
+            keep(unique);
+            {
+                auto a = DuinoMemory::make_pooled_shared<Linked>(pool);
+                auto b = DuinoMemory::make_pooled_shared<Linked>(pool);
+                a->next = b;
+                b->next = a;
+            }
+            DuinoMemory::collect_cycles();
+        });
+
+        if (DuinoMemory::collected_objects() != 0 || pool.in_use() != 0)
+        {
+            printf("collect_cycles left %zu objects tracked, %zu slots in use\n", DuinoMemory::collected_objects(), pool.in_use());
+            abort();
+        }
+    }
+
+    void sizes(void)
+    {
+        printf("\n-- Sizes (bytes) --\n");
+        printf("%-42s %3zu\n", "U_ptr", sizeof(DuinoMemory::U_ptr<Payload>));
+        printf("%-42s %3zu\n", "std::unique_ptr", sizeof(std::unique_ptr<Payload>));
+        printf("%-42s %3zu\n", "S_ptr", sizeof(DuinoMemory::S_ptr<Payload>));
+        printf("%-42s %3zu\n", "std::shared_ptr", sizeof(std::shared_ptr<Payload>));
+        printf("%-42s %3zu\n", "I_ptr", sizeof(DuinoMemory::I_ptr<Intrusive>));
+        printf("%-42s %3zu\n", "H_ptr", sizeof(DuinoMemory::H_ptr<Payload>));
+        printf("%-42s %3zu\n", "S_buf", sizeof(DuinoMemory::S_buf));
+        printf("%-42s %3zu\n", "SpscQueue<Payload, 8>", sizeof(DuinoMemory::SpscQueue<Payload, 8>));
+        printf("%-42s %3zu\n", "S_ptr control block (size_t count)", sizeof(DuinoMemory::ControlBlock<size_t, DuinoMemory::InterruptLock>));
+        printf("%-42s %3zu\n", "S_ptr control block (uint8_t count)", sizeof(DuinoMemory::ControlBlock<uint8_t, DuinoMemory::InterruptLock>));
+        printf("%-42s %3zu\n", "Tlsf block header", DuinoMemory::TlsfLayout::HEADER);
+    }
+}
+
+// Not inlined, so that the compiler does not pair malloc and free across
+// the replaced operators.
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    allocations++;
+    auto memory = malloc(size);
+    if (memory == nullptr)
+    {
+        abort();
+    }
+    return memory;
+}
+
+__attribute__((noinline)) void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void* memory, size_t size) noexcept
+{
+    (void)size;
+    free(memory);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        iterations = strtoul(argv[1], nullptr, 10);
+    }
+
+    printf("DuinoMemory host benchmark, %zu iterations per measure\n", iterations);
+    factories();
+    copies();
+    moves();
+    handoff();
+    allocators();
+    cycles();
+    sizes();
+    return 0;
+}
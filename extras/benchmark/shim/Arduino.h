@@ -0,0 +1,103 @@
+/*
+ ******************************************************************************
+ *  Arduino.h
+ *
+ *  Host shim of the Arduino core, for DuinoMemory benchmarks.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Provides the small subset of the Arduino API that DuinoMemory and its
+ *    examples rely on, so that they can be built and measured on a host
+ *    computer. Interrupt masking compiles to nothing, Serial writes to
+ *    the standard output.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+
+inline void noInterrupts(void)
+{
+    // No interrupts on the host.
+}
+
+inline void interrupts(void)
+{
+    // No interrupts on the host.
+}
+
+inline unsigned long micros(void)
+{
+    using namespace std::chrono;
+    static const auto start = steady_clock::now();
+    return static_cast<unsigned long>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+inline unsigned long millis(void)
+{
+    return micros() / 1000;
+}
+
+inline void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * Minimal Print, writing to the standard output.
+ */
+class Print
+{
+public:
+    size_t write(uint8_t byte)
+    {
+        return fputc(byte, stdout) != EOF ? 1 : 0;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size)
+    {
+        return fwrite(buffer, 1, size, stdout);
+    }
+
+    size_t print(const char* text) { return static_cast<size_t>(printf("%s", text)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(int value) { return static_cast<size_t>(printf("%d", value)); }
+    size_t print(unsigned int value) { return static_cast<size_t>(printf("%u", value)); }
+    size_t print(long value) { return static_cast<size_t>(printf("%ld", value)); }
+    size_t print(unsigned long value) { return static_cast<size_t>(printf("%lu", value)); }
+    size_t print(double value) { return static_cast<size_t>(printf("%.2f", value)); }
+
+    size_t println(void) { return print("\n"); }
+
+    template<typename T>
+    size_t println(T value)
+    {
+        auto written = print(value);
+        return written + println();
+    }
+};
+
+/**
+ * Serial port replacement: begin() does nothing.
+ */
+class HostSerial : public Print
+{
+public:
+    void begin(unsigned long baud)
+    {
+        (void)baud;
+    }
+};
+
+extern HostSerial Serial;
@@ -21,4 +21,16 @@
  */
 #pragma once
 #include "internal/U_ptr.hpp"
-#include "internal/S_ptr.hpp"
\ No newline at end of file
+#include "internal/S_ptr.hpp"
+#include "internal/ObjectPool.hpp"
+#include "internal/W_ptr.hpp"
+#include "internal/Arena.hpp"
+#include "internal/I_ptr.hpp"
+#include "internal/SpscQueue.hpp"
+#include "internal/S_buf.hpp"
+#include "internal/Cow_ptr.hpp"
+#include "internal/Tlsf.hpp"
+#include "internal/Allocator.hpp"
+#include "internal/CycleCollector.hpp"
+#include "internal/SlotMap.hpp"
+#include "internal/H_ptr.hpp"
\ No newline at end of file
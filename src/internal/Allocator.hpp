@@ -0,0 +1,237 @@
+/*
+ ******************************************************************************
+ *  Allocator.hpp
+ *
+ *  Smart pointers to objects created by a user supplied allocator.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    allocate_unique and allocate_shared create objects in memory obtained
+ *    from an allocator, e.g. an Arena, a Tlsf or an external PSRAM region,
+ *    and give it back to that allocator when the object is destroyed. An
+ *    allocator is any class providing:
+ *      void* allocate(size_t size, size_t alignment);  // nullptr if full
+ *      void deallocate(void* memory, size_t size);
+ *    Stateless allocators (empty classes) are created on demand and take
+ *    no room. Other allocators are referred to by pointer, from the U_ptr
+ *    deleter or from the S_ptr control block.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "U_ptr.hpp"
+#include "S_ptr.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Access to the allocator of an object. Stateful allocators must
+     * outlive every object they allocated.
+     * @param Alloc allocator type.
+     */
+    template<typename Alloc, bool Stateless = __is_empty(Alloc)>
+    class AllocatorRef
+    {
+    public:
+        AllocatorRef(void) = default;
+
+        explicit AllocatorRef(Alloc& alloc) : _alloc{ &alloc }
+        {
+            // Empty body
+        }
+
+        Alloc& allocator(void) const noexcept
+        {
+            return *_alloc;
+        }
+
+    private:
+        Alloc* _alloc{ };
+    };
+
+    template<typename Alloc>
+    class AllocatorRef<Alloc, true>
+    {
+    public:
+        AllocatorRef(void) = default;
+
+        explicit AllocatorRef(Alloc&)
+        {
+            // Empty body
+        }
+
+        Alloc allocator(void) const
+        {
+            return Alloc{ };
+        }
+    };
+
+    /**
+     * Deleter for U_ptr owning objects created by allocate_unique: runs the
+     * destructor and gives the memory back to the allocator. Takes no room
+     * for stateless allocators, one pointer otherwise.
+     * @param T type of the object.
+     * @param Alloc allocator type.
+     */
+    template<typename T, typename Alloc>
+    class AllocatorDelete : private AllocatorRef<Alloc>
+    {
+    public:
+        AllocatorDelete(void) = default;
+
+        explicit AllocatorDelete(Alloc& alloc) : AllocatorRef<Alloc>{ alloc }
+        {
+            // Empty body
+        }
+
+        void operator ()(T* data) const
+        {
+            data->~T();
+            AllocatorRef<Alloc>::allocator().deallocate(data, sizeof(T));
+        }
+    };
+
+    /**
+     * Control block embedding its object, allocated and freed by an
+     * allocator it keeps track of.
+     * @param T type of the embedded object.
+     * @param Alloc allocator type.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename T, typename Alloc, typename Count, typename Lock>
+    class AllocatedBlock final : public ControlBlock<Count, Lock>, private AllocatorRef<Alloc>
+    {
+    public:
+        /**
+         * Initializes this AllocatedBlock with raw storage for T.
+         * @param alloc allocator which provided the memory of this block.
+         * @param deferred true to destroy the object from reclaim().
+         */
+        AllocatedBlock(Alloc& alloc, bool deferred)
+            : ControlBlock<Count, Lock>{ ControlBlock<Count, Lock>::template manager<&AllocatedBlock<T, Alloc, Count, Lock>::manage>(deferred) },
+              AllocatorRef<Alloc>{ alloc }
+        {
+            // Empty body
+        }
+
+        /**
+         * Constructs the embedded object. Must be called exactly once,
+         * right after allocating this block.
+         * @param args must match one of T's constructors.
+         * @return a pointer to the newly constructed object.
+         */
+        template<class... Args>
+        T* construct(Args&&... args)
+        {
+            return ::new (static_cast<void*>(_storage)) T(DuinoMemory::forward<Args>(args)...);
+        }
+
+        /**
+         * Value initializes the embedded object. Must be called exactly
+         * once, right after allocating this block.
+         * @return a pointer to the newly constructed object.
+         */
+        T* construct(void)
+        {
+            return ::new (static_cast<void*>(_storage)) T{ };
+        }
+
+    private:
+        alignas(T) unsigned char _storage[sizeof(T)];
+
+        static void manage(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            auto self = static_cast<AllocatedBlock<T, Alloc, Count, Lock>*>(block);
+            if (operation == BlockOperation::DISPOSE)
+            {
+                reinterpret_cast<T*>(self->_storage)->~T();
+            }
+            else
+            {
+                // The block holds the allocator: keep it across destruction.
+                AllocatorRef<Alloc> ref{ *self };
+                self->~AllocatedBlock<T, Alloc, Count, Lock>();
+                ref.allocator().deallocate(self, sizeof(AllocatedBlock<T, Alloc, Count, Lock>));
+            }
+        }
+    };
+
+    /**
+     * Creates a value initialized T with memory from alloc.
+     * EXAMPLE: auto sample = allocate_unique<Sample>(psram);
+     * @param T type of the object.
+     * @param alloc allocator. Stateful ones must outlive the object.
+     * @return a new U_ptr, or nullptr if alloc is full.
+     */
+    template<typename T, typename Alloc>
+    U_ptr<T, AllocatorDelete<T, Alloc>> allocate_unique(Alloc& alloc)
+    {
+        static_assert(!is_array<T>::value, "allocate_unique does not support arrays");
+
+        auto memory = alloc.allocate(sizeof(T), alignof(T));
+        if (memory == nullptr)
+        {
+            return U_ptr<T, AllocatorDelete<T, Alloc>>{ };
+        }
+
+        return U_ptr<T, AllocatorDelete<T, Alloc>>{ ::new (memory) T{ }, AllocatorDelete<T, Alloc>{ alloc } };
+    }
+
+    /**
+     * Creates a T with memory from alloc.
+     * @param T type of the object.
+     * @param alloc allocator. Stateful ones must outlive the object.
+     * @param args must match one of T's constructors.
+     * @return a new U_ptr, or nullptr if alloc is full.
+     */
+    template<typename T, typename Alloc, class... Args>
+    U_ptr<T, AllocatorDelete<T, Alloc>> allocate_unique(Alloc& alloc, Args&&... args)
+    {
+        static_assert(!is_array<T>::value, "allocate_unique does not support arrays");
+
+        auto memory = alloc.allocate(sizeof(T), alignof(T));
+        if (memory == nullptr)
+        {
+            return U_ptr<T, AllocatorDelete<T, Alloc>>{ };
+        }
+
+        return U_ptr<T, AllocatorDelete<T, Alloc>>{ ::new (memory) T(DuinoMemory::forward<Args>(args)...), AllocatorDelete<T, Alloc>{ alloc } };
+    }
+
+    /**
+     * Creates a T and its control block in a single piece of memory from
+     * alloc, given back to it once the last S_ptr and W_ptr are gone.
+     * EXAMPLE: S_ptr<Frame> frame = allocate_shared<Frame>(frame_heap, id);
+     * @param T type of the object.
+     * @param alloc allocator. Stateful ones must outlive the object.
+     * @param args must match one of T's constructors.
+     * @return a new S_ptr, or nullptr if alloc is full.
+     */
+    template<typename T, typename Alloc, class... Args>
+    S_ptr<T> allocate_shared(Alloc& alloc, Args&&... args)
+    {
+        static_assert(!is_array<T>::value, "allocate_shared does not support arrays");
+
+        using Traits = SharedTraits<T>;
+        using Block = AllocatedBlock<T, Alloc, typename Traits::count_type, typename Traits::lock_type>;
+
+        auto memory = alloc.allocate(sizeof(Block), alignof(Block));
+        if (memory == nullptr)
+        {
+            return S_ptr<T>{ };
+        }
+
+        auto block = ::new (memory) Block{ alloc, Traits::deferred };
+        return SharedFactory::from_block<T, typename Traits::count_type, typename Traits::lock_type>(
+            block->construct(DuinoMemory::forward<Args>(args)...), block);
+    }
+}
@@ -0,0 +1,230 @@
+/*
+ ******************************************************************************
+ *  Arena.hpp
+ *
+ *  Bump allocator with bulk release for DuinoMemory smart pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Arena hands out memory from a user supplied buffer by moving a cursor
+ *    forward. make_unique_in and make_shared_in create objects in an arena;
+ *    their pointers run destructors but never free memory individually.
+ *    The whole arena is reclaimed at once by reset(), e.g. at the end of
+ *    each loop() iteration.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "U_ptr.hpp"
+#include "S_ptr.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Linear allocator over a buffer it does not own. Allocation is a
+     * pointer bump, and memory is only ever released all at once.
+     * CAUTION: every object created in the arena must be destroyed before
+     *          calling reset(); their memory is reused afterwards.
+     */
+    class Arena final
+    {
+    public:
+        /**
+         * Initializes this Arena over the provided buffer.
+         * @param buffer memory to allocate from. Must outlive this Arena.
+         * @param size of buffer, in bytes.
+         */
+        Arena(void* buffer, size_t size) : _buffer{ static_cast<unsigned char*>(buffer) }, _size{ size }
+        {
+            // Empty body
+        }
+
+        Arena(const Arena& other) = delete;
+        Arena& operator =(const Arena& other) = delete;
+
+        /**
+         * Reserves memory from this Arena.
+         * @param size in bytes.
+         * @param alignment of the memory to reserve. Must be a power of 2.
+         * @return the reserved memory, or nullptr if the arena is full.
+         */
+        void* allocate(size_t size, size_t alignment)
+        {
+            auto address = reinterpret_cast<uintptr_t>(_buffer + _used);
+            auto padding = static_cast<size_t>(-address & (alignment - 1));
+
+            if (padding + size > _size - _used)
+            {
+                return nullptr;
+            }
+
+            auto memory = _buffer + _used + padding;
+            _used += padding + size;
+            return memory;
+        }
+
+        /**
+         * Does nothing: memory is only reclaimed by reset(). Lets an Arena
+         * be given to allocate_unique and allocate_shared.
+         */
+        void deallocate(void*, size_t) noexcept
+        {
+            // Empty body
+        }
+
+        /**
+         * Makes the whole buffer available again, in constant time.
+         * Does not run any destructor.
+         */
+        void reset(void) noexcept
+        {
+            _used = 0;
+        }
+
+        /**
+         * @return the number of bytes reserved since the last reset,
+         *         alignment padding included.
+         */
+        size_t used(void) const noexcept
+        {
+            return _used;
+        }
+
+        /**
+         * @return the size of the underlying buffer, in bytes.
+         */
+        size_t capacity(void) const noexcept
+        {
+            return _size;
+        }
+
+    private:
+        unsigned char* _buffer;
+        size_t _size;
+        size_t _used{ };
+    };
+
+    /**
+     * Deleter for U_ptr owning objects created in an Arena: runs the
+     * destructor and leaves the memory to the arena.
+     * @param T type of the object.
+     */
+    template<typename T>
+    struct ArenaDelete
+    {
+        void operator ()(T* data) const
+        {
+            data->~T();
+        }
+    };
+
+    /**
+     * Control block embedding its object, allocated in an Arena. The
+     * object is destroyed with its last S_ptr, the memory only on reset.
+     * @param T type of the embedded object.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename T, typename Count, typename Lock>
+    class ArenaBlock final : public ControlBlock<Count, Lock>
+    {
+    public:
+        /**
+         * Initializes this ArenaBlock with raw storage for T.
+         */
+        ArenaBlock(void) : ControlBlock<Count, Lock>{ &ArenaBlock<T, Count, Lock>::manage }
+        {
+            // Empty body
+        }
+
+        /**
+         * Constructs the embedded object. Must be called exactly once,
+         * right after allocating this block.
+         * @param args must match one of T's constructors.
+         * @return a pointer to the newly constructed object.
+         */
+        template<class... Args>
+        T* construct(Args&&... args)
+        {
+            return ::new (static_cast<void*>(_storage)) T(DuinoMemory::forward<Args>(args)...);
+        }
+
+        /**
+         * Value initializes the embedded object. Must be called exactly
+         * once, right after allocating this block.
+         * @return a pointer to the newly constructed object.
+         */
+        T* construct(void)
+        {
+            return ::new (static_cast<void*>(_storage)) T{ };
+        }
+
+    private:
+        alignas(T) unsigned char _storage[sizeof(T)];
+
+        static void manage(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            // Deallocation is left to Arena::reset().
+            if (operation == BlockOperation::DISPOSE)
+            {
+                auto self = static_cast<ArenaBlock<T, Count, Lock>*>(block);
+                reinterpret_cast<T*>(self->_storage)->~T();
+            }
+        }
+    };
+
+    /**
+     * Creates an object in arena, owned by a U_ptr that only runs its
+     * destructor.
+     * @param T type of the object.
+     * @param arena to allocate from.
+     * @param args must match one of T's constructors.
+     * @return a new U_ptr, or nullptr if the arena is full.
+     */
+    template<typename T, class... Args>
+    U_ptr<T, ArenaDelete<T>> make_unique_in(Arena& arena, Args&&... args)
+    {
+        auto memory = arena.allocate(sizeof(T), alignof(T));
+        if (memory == nullptr)
+        {
+            return U_ptr<T, ArenaDelete<T>>{ };
+        }
+
+        return U_ptr<T, ArenaDelete<T>>{ ::new (memory) T(DuinoMemory::forward<Args>(args)...) };
+    }
+
+    /**
+     * Creates an object and its control block in arena, in one piece.
+     * The object is destroyed with its last S_ptr; its memory is reclaimed
+     * by Arena::reset().
+     * @param T type of the object.
+     * @param arena to allocate from.
+     * @param args must match one of T's constructors.
+     * @return a new S_ptr, or nullptr if the arena is full.
+     */
+    template<typename T, class... Args>
+    S_ptr<T> make_shared_in(Arena& arena, Args&&... args)
+    {
+        using Traits = SharedTraits<T>;
+        using Block = ArenaBlock<T, typename Traits::count_type, typename Traits::lock_type>;
+
+        auto memory = arena.allocate(sizeof(Block), alignof(Block));
+        if (memory == nullptr)
+        {
+            return S_ptr<T>{ };
+        }
+
+        auto block = ::new (memory) Block{ };
+        return SharedFactory::from_block<T, typename Traits::count_type, typename Traits::lock_type>(
+            block->construct(DuinoMemory::forward<Args>(args)...), block);
+    }
+}
@@ -0,0 +1,523 @@
+/*
+ ******************************************************************************
+ *  ControlBlock.hpp
+ *
+ *  Reference counting blocks for DuinoMemory shared pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    A control block holds the reference counts of an object shared by
+ *    several S_ptr and observed by W_ptr, along with the function that
+ *    destroys the object once the strong count drops to zero. Concrete
+ *    blocks either adopt an existing object or embed it (or an array of
+ *    them), so that make_shared only needs one allocation.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "CycleNode.hpp"
+#include "DefaultDelete.hpp"
+#include "Heap.hpp"
+#include "Instrumentation.hpp"
+#include "Locks.hpp"
+#include "Reclaim.hpp"
+#include "Utility.hpp"
+
+#if defined(__AVR__)
+#include <new.h>
+#else
+#include <new>
+#endif
+
+namespace DuinoMemory
+{
+    /**
+     * Operations performed by the concrete control block manager.
+     */
+    enum class BlockOperation
+    {
+        DISPOSE,        // Destroy the managed object.
+        DEALLOCATE,     // Free the control block itself.
+        RECLAIM         // Destroy a deferred object, from reclaim().
+    };
+
+    /**
+     * Default settings of the S_ptr created by the factories.
+     */
+    struct DefaultSharedTraits
+    {
+        // Unsigned integer type of the reference counts.
+        using count_type = size_t;
+
+        // Policy protecting reference count updates, see Locks.hpp.
+        using lock_type = InterruptLock;
+
+        // When true, objects are not destroyed by their last S_ptr but
+        // queued until reclaim() is called, see Reclaim.hpp.
+        static constexpr bool deferred = false;
+    };
+
+    /**
+     * Per type settings of the S_ptr created by the factories. Specialize
+     * it to change the defaults for a given type; inheriting from
+     * DefaultSharedTraits keeps the settings left untouched.
+     * EXAMPLE: namespace DuinoMemory
+     *          {
+     *              template<>
+     *              struct SharedTraits<Route> : DefaultSharedTraits
+     *              {
+     *                  using count_type = uint8_t;
+     *              };
+     *          }
+     * @param T type of the shared objects.
+     */
+    template<typename T>
+    struct SharedTraits : DefaultSharedTraits
+    {
+        // Empty body
+    };
+
+    /**
+     * Type agnostic part of the control block. Holds the strong and weak
+     * reference counts and a pointer to the function managing both the
+     * object and this block. A single function pointer is used instead of
+     * virtual methods as AVR keeps vtables in RAM.
+     * The weak count includes one extra reference held by the S_ptr as a
+     * group, so that the block outlives its last S_ptr while W_ptr remain.
+     * Counts saturate: once a count reaches the maximum value of Count, it
+     * sticks to it and the object (or the block) is never freed.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates. With
+     *        Collected, the block also takes part in collect_cycles().
+     */
+    template<typename Count, typename Lock>
+    class ControlBlock : public CycleNode<Count, Lock>
+    {
+        static_assert(static_cast<Count>(-1) > static_cast<Count>(0), "Count must be an unsigned integer type");
+
+    public:
+        /**
+         * Count value at which references stop being counted.
+         */
+        static constexpr Count SATURATED = saturated_count<Count>();
+
+        /**
+         * @return the number of S_ptr referencing this block.
+         */
+        size_t count(void) const noexcept
+        {
+            return _count;
+        }
+
+        /**
+         * Adds one strong reference to this block.
+         */
+        void acquire(void)
+        {
+            Lock::increment(_count);
+        }
+
+        /**
+         * Adds one strong reference to this block, unless the managed
+         * object has already been destroyed.
+         * @return true if the reference was added.
+         */
+        bool try_acquire(void)
+        {
+            return Lock::increment_if_alive(_count);
+        }
+
+        /**
+         * Removes one strong reference from this block. When it was the
+         * last one, destroys the managed object, then this block if no
+         * W_ptr observes it anymore. Destruction happens outside of the
+         * Lock critical section.
+         * CAUTION: this block must not be used afterwards.
+         */
+        void release(void)
+        {
+            auto remaining = Lock::decrement(_count);
+
+            if (remaining == 0)
+            {
+                CycleNode<Count, Lock>::untrack();
+                _manage(this, BlockOperation::DISPOSE);
+
+                // Without any W_ptr, nothing else can reach this block:
+                // the weak count does not need to be updated.
+                if (_weak == 1)
+                {
+                    _manage(this, BlockOperation::DEALLOCATE);
+                }
+                else
+                {
+                    release_weak();
+                }
+            }
+        }
+
+        /**
+         * Adds one weak reference to this block.
+         */
+        void acquire_weak(void)
+        {
+            Lock::increment(_weak);
+        }
+
+        /**
+         * Removes one weak reference from this block, and frees it if that
+         * was the last reference of any kind.
+         * CAUTION: this block must not be used afterwards.
+         */
+        void release_weak(void)
+        {
+            auto remaining = Lock::decrement(_weak);
+
+            if (remaining == 0)
+            {
+                _manage(this, BlockOperation::DEALLOCATE);
+            }
+        }
+
+    protected:
+        using Manager = void (*)(ControlBlock<Count, Lock>*, BlockOperation);
+
+        /**
+         * Initializes this ControlBlock with a strong count of 1.
+         * @param manage function disposing of the managed object or
+         *        deallocating the concrete block. Cannot be nullptr.
+         */
+        explicit ControlBlock(Manager manage) : _manage{ manage }
+        {
+            // Empty body
+        }
+
+        /**
+         * Selects the manager of a concrete block.
+         * @param Manage manager of the concrete block.
+         * @param deferred true to queue the object for reclaim() instead of
+         *        disposing of it with its last S_ptr.
+         */
+        template<Manager Manage>
+        static constexpr Manager manager(bool deferred)
+        {
+            return deferred ? &ControlBlock<Count, Lock>::defer<Manage> : Manage;
+        }
+
+    private:
+        // Blocks of deferred objects waiting for reclaim(), oldest first.
+        struct Deferred
+        {
+            ControlBlock<Count, Lock>* first;
+            ControlBlock<Count, Lock>* last;
+            size_t length;
+        };
+
+        Count _count{ 1 };
+        Count _weak{ 1 };
+        Manager _manage;
+        ControlBlock<Count, Lock>* _next_deferred{ };
+
+        static Deferred& deferred(void)
+        {
+            static Deferred queue{ };
+            return queue;
+        }
+
+        static ReclaimSource& source(void)
+        {
+            static ReclaimSource self{ &ControlBlock<Count, Lock>::reclaim_deferred,
+                &ControlBlock<Count, Lock>::deferred_pending, nullptr, false };
+            return self;
+        }
+
+        // Queues the object instead of disposing of it. The extra weak
+        // reference keeps this block alive until reclaim() reaches it.
+        template<Manager Manage>
+        static void defer(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            switch (operation)
+            {
+            case BlockOperation::DISPOSE:
+                block->acquire_weak();
+                enqueue(block);
+                break;
+
+            case BlockOperation::RECLAIM:
+                Manage(block, BlockOperation::DISPOSE);
+                block->release_weak();
+                break;
+
+            default:
+                Manage(block, operation);
+                break;
+            }
+        }
+
+        static void enqueue(ControlBlock<Count, Lock>* block)
+        {
+            auto& queue = deferred();
+            {
+                InterruptGuard guard{ };
+                block->_next_deferred = nullptr;
+                if (queue.last != nullptr)
+                {
+                    queue.last->_next_deferred = block;
+                }
+                else
+                {
+                    queue.first = block;
+                }
+                queue.last = block;
+                queue.length++;
+            }
+
+            // Registers once, then only reads the flag.
+            if (!source().registered)
+            {
+                ReclaimQueue::instance().attach(source());
+            }
+        }
+
+        static bool reclaim_deferred(void)
+        {
+            auto& queue = deferred();
+            ControlBlock<Count, Lock>* block;
+            {
+                InterruptGuard guard{ };
+                block = queue.first;
+                if (block == nullptr)
+                {
+                    return false;
+                }
+
+                queue.first = block->_next_deferred;
+                if (queue.first == nullptr)
+                {
+                    queue.last = nullptr;
+                }
+                queue.length--;
+            }
+
+            // Destroyed outside of the critical section.
+            block->_manage(block, BlockOperation::RECLAIM);
+            return true;
+        }
+
+        static size_t deferred_pending(void)
+        {
+            InterruptGuard guard{ };
+            return deferred().length;
+        }
+    };
+
+    /**
+     * Control block taking ownership of an object allocated elsewhere,
+     * e.g. by a raw new. Both get destroyed separately.
+     * @param T type of the adopted object, or array type (e.g. int[]) for
+     *          arrays allocated by new[].
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename T, typename Count, typename Lock>
+    class AdoptedBlock final : public ControlBlock<Count, Lock>
+    {
+    public:
+        /**
+         * Initializes this AdoptedBlock with the object to delete once
+         * the count reaches 0.
+         * @param data cannot be nullptr.
+         * @param deferred true to delete data from reclaim() instead.
+         */
+        explicit AdoptedBlock(typename remove_extent<T>::type* data, bool deferred = false)
+            : ControlBlock<Count, Lock>{ ControlBlock<Count, Lock>::template manager<&AdoptedBlock<T, Count, Lock>::manage>(deferred) }, _data{ data }
+        {
+            record_allocation<T>(bytes());
+        }
+
+    private:
+        typename remove_extent<T>::type* _data;
+
+        // Object and block, as counted by the instrumentation.
+        static constexpr size_t bytes(void)
+        {
+            return tracked_size<T>::value + sizeof(AdoptedBlock<T, Count, Lock>);
+        }
+
+        static void manage(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            auto self = static_cast<AdoptedBlock<T, Count, Lock>*>(block);
+            if (operation == BlockOperation::DISPOSE)
+            {
+                DefaultDelete<T>{ }(self->_data);
+            }
+            else
+            {
+                record_release<T>(bytes());
+                heap_delete(self);
+            }
+        }
+    };
+
+    /**
+     * Control block embedding its object, so that both are allocated
+     * and freed at once. The object is constructed separately, see
+     * construct().
+     * @param T type of the embedded object. Since the block knows the
+     *          concrete type, it is always destroyed properly.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename T, typename Count, typename Lock>
+    class InplaceBlock final : public ControlBlock<Count, Lock>
+    {
+    public:
+        /**
+         * Initializes this InplaceBlock with raw storage for T.
+         * @param deferred true to destroy the object from reclaim().
+         */
+        explicit InplaceBlock(bool deferred = false)
+            : ControlBlock<Count, Lock>{ ControlBlock<Count, Lock>::template manager<&InplaceBlock<T, Count, Lock>::manage>(deferred) }
+        {
+            record_allocation<T>(sizeof(InplaceBlock<T, Count, Lock>));
+        }
+
+        /**
+         * Constructs the embedded object. Must be called exactly once,
+         * right after allocating this block.
+         * @param args must match one of T's constructors.
+         * @return a pointer to the newly constructed object.
+         */
+        template<class... Args>
+        T* construct(Args&&... args)
+        {
+            return ::new (static_cast<void*>(_storage)) T(DuinoMemory::forward<Args>(args)...);
+        }
+
+        /**
+         * Value initializes the embedded object. Must be called exactly
+         * once, right after allocating this block.
+         * @return a pointer to the newly constructed object.
+         */
+        T* construct(void)
+        {
+            return ::new (static_cast<void*>(_storage)) T{ };
+        }
+
+    private:
+        alignas(T) unsigned char _storage[sizeof(T)];
+
+        T* object(void)
+        {
+            return reinterpret_cast<T*>(_storage);
+        }
+
+        static void manage(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            auto self = static_cast<InplaceBlock<T, Count, Lock>*>(block);
+            if (operation == BlockOperation::DISPOSE)
+            {
+                self->object()->~T();
+            }
+            else
+            {
+                record_release<T>(sizeof(InplaceBlock<T, Count, Lock>));
+                heap_delete(self);
+            }
+        }
+    };
+
+    /**
+     * Control block followed by an array of elements, so that both are
+     * allocated and freed at once. The number of elements is only known
+     * at run time, hence the create() function instead of new.
+     * @param T type of the array elements.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename T, typename Count, typename Lock>
+    class ArrayBlock final : public ControlBlock<Count, Lock>
+    {
+    public:
+        /**
+         * Allocates a block with room for size elements, and value
+         * initializes them (zeros for arithmetic types).
+         * @param size number of elements.
+         * @param deferred true to destroy the elements from reclaim().
+         * @return the new block, or nullptr if allocation failed.
+         */
+        static ArrayBlock<T, Count, Lock>* create(size_t size, bool deferred = false)
+        {
+            if (size > (static_cast<size_t>(-1) - offset()) / sizeof(T))
+            {
+                return nullptr;
+            }
+
+            auto memory = heap_allocate(offset() + size * sizeof(T));
+            if (memory == nullptr)
+            {
+                return nullptr;
+            }
+
+            auto block = ::new (memory) ArrayBlock<T, Count, Lock>{ size, deferred };
+            for (size_t i = 0; i < size; i++)
+            {
+                ::new (static_cast<void*>(block->elements() + i)) T();
+            }
+
+            record_allocation<T[]>(offset() + size * sizeof(T));
+            return block;
+        }
+
+        /**
+         * @return a pointer to the first element.
+         */
+        T* elements(void)
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(this) + offset());
+        }
+
+    private:
+        size_t _size;
+
+        ArrayBlock(size_t size, bool deferred)
+            : ControlBlock<Count, Lock>{ ControlBlock<Count, Lock>::template manager<&ArrayBlock<T, Count, Lock>::manage>(deferred) }, _size{ size }
+        {
+            // Empty body
+        }
+
+        // Distance from the block to its first element.
+        static constexpr size_t offset(void)
+        {
+            return (sizeof(ArrayBlock<T, Count, Lock>) + alignof(T) - 1) / alignof(T) * alignof(T);
+        }
+
+        static void manage(ControlBlock<Count, Lock>* block, BlockOperation operation)
+        {
+            auto self = static_cast<ArrayBlock<T, Count, Lock>*>(block);
+            if (operation == BlockOperation::DISPOSE)
+            {
+                // Destroy in reverse order of construction.
+                for (auto i = self->_size; i > 0; i--)
+                {
+                    self->elements()[i - 1].~T();
+                }
+            }
+            else
+            {
+                record_release<T[]>(offset() + self->_size * sizeof(T));
+                self->~ArrayBlock<T, Count, Lock>();
+                heap_deallocate(self);
+            }
+        }
+    };
+}
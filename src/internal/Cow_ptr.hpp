@@ -0,0 +1,122 @@
+/*
+ ******************************************************************************
+ *  Cow_ptr.hpp
+ *
+ *  Copy-on-write shared pointer for Arduino.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Cow_ptr shares a read only object through an S_ptr. Copies are as
+ *    cheap as S_ptr copies; the object is only cloned when one of its
+ *    owners asks to modify it while others still share it. Owners that
+ *    never write never pay for a copy.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "S_ptr.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Shares an object until it is modified. Reading goes through the
+     * const accessors; write() gives a private copy first if needed.
+     * EXAMPLE: Cow_ptr<Config> mine = shared_config;   // No copy
+     *          mine.write()->threshold = 12;           // Cloned here
+     * @param T must be copy constructible. CAUTION: T is cloned as a T,
+     *          so it must be the concrete type of the object.
+     */
+    template<typename T>
+    class Cow_ptr final
+    {
+    public:
+        /**
+         * Initializes this Cow_ptr as nullptr.
+         */
+        Cow_ptr(void) = default;
+
+        /**
+         * Initializes this Cow_ptr sharing the object owned by shared.
+         * CAUTION: holders of shared itself may still modify the object.
+         * @param shared can be nullptr.
+         */
+        explicit Cow_ptr(S_ptr<T> shared) : _shared{ DuinoMemory::move(shared) }
+        {
+            // Empty body
+        }
+
+        /**
+         * @return the object, read only.
+         */
+        const T* get(void) const
+        {
+            return _shared.get();
+        }
+
+        /**
+         * Warning:
+         *   Dereferencing a null Cow_ptr (* or ->) leads to undefined behavior.
+         */
+        const T& operator *(void) const { return *_shared; }
+        const T* operator ->(void) const { return _shared.get(); }
+
+        explicit operator bool(void) const
+        {
+            return static_cast<bool>(_shared);
+        }
+
+        /**
+         * @return the number of owners sharing the object.
+         */
+        size_t count(void) const noexcept
+        {
+            return _shared.count();
+        }
+
+        /**
+         * Gives access to the object for modification. If other owners
+         * share it, clones it first, so that they are not affected.
+         * CAUTION: do not keep the returned pointer across copies of this
+         *          Cow_ptr; call write() again instead.
+         * @return the object, owned by this Cow_ptr only, or nullptr if
+         *         this Cow_ptr is null or the clone could not be allocated
+         *         (the shared object is then left untouched).
+         */
+        T* write(void)
+        {
+            if (_shared.count() > 1)
+            {
+                auto clone = make_shared<T>(*_shared);
+                if (!clone)
+                {
+                    return nullptr;
+                }
+                _shared = DuinoMemory::move(clone);
+            }
+            return _shared.get();
+        }
+
+    private:
+        S_ptr<T> _shared{ };
+    };
+
+    /**
+     * Creates an instance of T with the provided arguments, owned by a
+     * Cow_ptr.
+     * @param args must match one of T's constructors.
+     * @return a new Cow_ptr, or nullptr if allocation failed.
+     */
+    template<typename T, class... Args>
+    Cow_ptr<T> make_cow(Args&&... args)
+    {
+        return Cow_ptr<T>{ make_shared<T>(DuinoMemory::forward<Args>(args)...) };
+    }
+}
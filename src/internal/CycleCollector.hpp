@@ -0,0 +1,322 @@
+/*
+ ******************************************************************************
+ *  CycleCollector.hpp
+ *
+ *  Incremental collection of S_ptr reference cycles.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Objects referencing each other through S_ptr never see their count
+ *    drop to zero, and leak. For types whose lock policy is Collected and
+ *    which enumerate their S_ptr in a trace() member, collect_cycles()
+ *    finds such groups by trial deletion, in the manner of Bacon and
+ *    Rajan's synchronous cycle collector. Starting from a candidate
+ *    object, it walks the graph of objects it reaches, and subtracts the
+ *    references this graph holds on itself from their counts. Objects
+ *    left with references, and everything they reach, are in use; the
+ *    others are only referenced from within the graph. Their S_ptr are
+ *    then released, which destroys them through the usual release() path.
+ *    Candidates are taken in turn from the list of Collected objects, and
+ *    each call walks a bounded number of objects, so that collection can
+ *    be spread over loop() calls.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "CycleNode.hpp"
+#include "S_ptr.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Collector of the objects whose control blocks use Count and Lock.
+     * Also the visitor passed to the trace() members, which must call it
+     * with each S_ptr of their object.
+     * EXAMPLE: struct State
+     *          {
+     *              S_ptr<State> on_timeout;
+     *              S_ptr<State> on_error;
+     *
+     *              template<typename Visitor>
+     *              void trace(Visitor& visit)
+     *              {
+     *                  visit(on_timeout);
+     *                  visit(on_error);
+     *              }
+     *          };
+     * CAUTION: collected objects and their S_ptr must not be used from
+     *          ISRs, which could change the graph during a collection.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock Collected lock policy.
+     */
+    template<typename Count, typename Lock>
+    class CycleCollector final
+    {
+    public:
+        CycleCollector(const CycleCollector<Count, Lock>& other) = delete;
+        CycleCollector<Count, Lock>& operator =(const CycleCollector<Count, Lock>& other) = delete;
+
+        /**
+         * @return the collector of all objects using Count and Lock.
+         */
+        static CycleCollector<Count, Lock>& instance(void)
+        {
+            static CycleCollector<Count, Lock> collector{ };
+            return collector;
+        }
+
+        /**
+         * Examines candidate objects in turn, and destroys the garbage
+         * cycles they belong to. A candidate whose graph does not fit in
+         * what is left of the budget is left untouched, and examined first
+         * by the next call; one that does not even fit in a whole budget is
+         * skipped.
+         * @param budget maximum number of objects to walk.
+         * @return the number of objects destroyed.
+         */
+        size_t collect(size_t budget)
+        {
+            if (_running)
+            {
+                // Called from the destructor of a collected object.
+                return 0;
+            }
+
+            _running = true;
+            size_t visited = 0;
+            size_t destroyed = 0;
+            for (auto candidates = Node::size(); candidates > 0 && visited < budget; candidates--)
+            {
+                auto root = Node::cursor() != nullptr ? Node::cursor() : Node::head();
+                if (root == nullptr)
+                {
+                    break;
+                }
+
+                auto start = visited;
+                if (!mark(root, budget - visited, visited))
+                {
+                    Node::cursor() = start == 0 ? root->_next : root;
+                    break;
+                }
+
+                Node::cursor() = root->_next;
+                destroyed += sweep(root);
+            }
+            _running = false;
+            return destroyed;
+        }
+
+        /**
+         * @return the number of live objects using Count and Lock.
+         */
+        size_t tracked(void) const
+        {
+            InterruptGuard guard{ };
+            return Node::size();
+        }
+
+        /**
+         * Visits an S_ptr held by the object being traced.
+         */
+        template<typename T>
+        void operator ()(S_ptr<T, Count, Lock>& edge)
+        {
+            Node* node = edge._control;
+            if (node == nullptr)
+            {
+                return;
+            }
+
+            switch (_pass)
+            {
+            case Pass::MARK:
+                if (node->_color != Color::GRAY)
+                {
+                    gray(node);
+                    _last->_member = node;
+                    _last = node;
+                }
+                if (node->_external != Block::SATURATED)
+                {
+                    node->_external--;
+                }
+                break;
+
+            case Pass::SCAN:
+                if (node->_color == Color::GRAY)
+                {
+                    node->_color = Color::LIVE;
+                    node->_work = nullptr;
+                    _last->_work = node;
+                    _last = node;
+                }
+                break;
+
+            case Pass::CLEAR:
+                edge.release();
+                break;
+            }
+        }
+
+        /**
+         * S_ptr to objects of other collectors, or not collected, are not
+         * part of the graph.
+         */
+        template<typename T, typename C, typename L>
+        void operator ()(S_ptr<T, C, L>&)
+        {
+            // Not part of the graph.
+        }
+
+    private:
+        using Node = CycleNode<Count, Lock>;
+        using Color = typename Node::Color;
+        using Block = ControlBlock<Count, Lock>;
+
+        enum class Pass : uint8_t
+        {
+            MARK,       // Gathers the graph, subtracting its own references.
+            SCAN,       // Marks the objects reachable from outside.
+            CLEAR       // Releases the S_ptr of garbage objects.
+        };
+
+        Node* _last{ };     // Tail of the list being built.
+        Pass _pass{ Pass::MARK };
+        bool _running{ };
+
+        CycleCollector(void) = default;
+
+        void trace(Node* node)
+        {
+            if (node->_trace != nullptr)
+            {
+                node->_trace(node->_object, *this);
+            }
+        }
+
+        static void gray(Node* node)
+        {
+            // Saturated counts are never decremented: such objects stay.
+            node->_color = Color::GRAY;
+            node->_member = nullptr;
+            node->_external = static_cast<Count>(static_cast<Block*>(node)->count());
+        }
+
+        // Gathers the graph reachable from root, and subtracts the
+        // references it holds on itself. Gives up, leaving every node as it
+        // was, if the graph has more than budget objects.
+        bool mark(Node* root, size_t budget, size_t& visited)
+        {
+            _pass = Pass::MARK;
+            gray(root);
+            _last = root;
+            for (auto node = root; node != nullptr; node = node->_member)
+            {
+                if (budget == 0)
+                {
+                    for (auto member = root; member != nullptr; member = member->_member)
+                    {
+                        member->_color = Color::BLACK;
+                    }
+                    return false;
+                }
+
+                trace(node);
+                visited++;
+                budget--;
+            }
+            return true;
+        }
+
+        // Destroys the objects of the graph marked from root that are only
+        // referenced from within it. Walks the same nodes as mark().
+        size_t sweep(Node* root)
+        {
+            _pass = Pass::SCAN;
+            for (auto node = root; node != nullptr; node = node->_member)
+            {
+                if (node->_color == Color::GRAY && node->_external > 0)
+                {
+                    node->_color = Color::LIVE;
+                    node->_work = nullptr;
+                    _last = node;
+                    for (auto live = node; live != nullptr; live = live->_work)
+                    {
+                        trace(live);
+                    }
+                }
+            }
+
+            // Objects still gray are only referenced by each other. Keep
+            // them alive until all their S_ptr are released, so that none
+            // is destroyed while the others are being cleared.
+            Node* garbage = nullptr;
+            size_t count = 0;
+            for (auto node = root; node != nullptr; node = node->_member)
+            {
+                if (node->_color == Color::GRAY)
+                {
+                    static_cast<Block*>(node)->acquire();
+                    node->_work = garbage;
+                    garbage = node;
+                    count++;
+                }
+                node->_color = Color::BLACK;
+            }
+
+            _pass = Pass::CLEAR;
+            for (auto node = garbage; node != nullptr; node = node->_work)
+            {
+                trace(node);
+            }
+
+            while (garbage != nullptr)
+            {
+                auto next = garbage->_work;
+                static_cast<Block*>(garbage)->release();
+                garbage = next;
+            }
+            return count;
+        }
+    };
+
+    /**
+     * Destroys garbage cycles of collected objects. Call it from loop();
+     * each call resumes with the next candidate objects.
+     * EXAMPLE: void loop()
+     *          {
+     *              DuinoMemory::collect_cycles(32);
+     *          }
+     * @param Count count type of the collected objects.
+     * @param Lock lock policy of the collected objects.
+     * @param budget maximum number of objects to walk. Cycles larger than
+     *        it are only collected by a call with a larger budget.
+     * @return the number of objects destroyed.
+     */
+    template<typename Count = DefaultSharedTraits::count_type, typename Lock = Collected<DefaultSharedTraits::lock_type>>
+    size_t collect_cycles(size_t budget = static_cast<size_t>(-1))
+    {
+        return CycleCollector<Count, Lock>::instance().collect(budget);
+    }
+
+    /**
+     * @param Count count type of the collected objects.
+     * @param Lock lock policy of the collected objects.
+     * @return the number of live objects examined by collect_cycles().
+     */
+    template<typename Count = DefaultSharedTraits::count_type, typename Lock = Collected<DefaultSharedTraits::lock_type>>
+    size_t collected_objects(void)
+    {
+        return CycleCollector<Count, Lock>::instance().tracked();
+    }
+}
@@ -0,0 +1,253 @@
+/*
+ ******************************************************************************
+ *  CycleNode.hpp
+ *
+ *  Control block bookkeeping of the S_ptr cycle collector.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Every control block derives from a CycleNode. It is empty, hence
+ *    free, unless the lock policy of the block is Collected: once owned by
+ *    an S_ptr, the block joins the list of objects examined by
+ *    collect_cycles(), and remembers how to enumerate the S_ptr held by its
+ *    object. See CycleCollector.hpp.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "Locks.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Lock policy of objects whose reference cycles are reclaimed by
+     * collect_cycles(). Counts are updated as with Lock.
+     * EXAMPLE: namespace DuinoMemory
+     *          {
+     *              template<>
+     *              struct SharedTraits<Node> : DefaultSharedTraits
+     *              {
+     *                  using lock_type = Collected<>;
+     *              };
+     *          }
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename Lock = InterruptLock>
+    struct Collected : Lock
+    {
+        // Empty body
+    };
+
+    template<typename Count, typename Lock>
+    class CycleCollector;
+
+    /**
+     * Part of the control block used by the cycle collector. Empty for
+     * lock policies other than Collected.
+     * @param Count unsigned integer type of the reference counts.
+     * @param Lock policy protecting reference count updates.
+     */
+    template<typename Count, typename Lock>
+    class CycleNode
+    {
+    protected:
+        void untrack(void)
+        {
+            // Not collected.
+        }
+    };
+
+    template<typename Count, typename Lock>
+    class CycleNode<Count, Collected<Lock>>
+    {
+        friend class CycleCollector<Count, Collected<Lock>>;
+
+    public:
+        // Calls the collector with each S_ptr of an object.
+        using Trace = void (*)(void*, CycleCollector<Count, Collected<Lock>>&);
+
+        CycleNode(const CycleNode<Count, Collected<Lock>>& other) = delete;
+        CycleNode<Count, Collected<Lock>>& operator =(const CycleNode<Count, Collected<Lock>>& other) = delete;
+
+        /**
+         * Gives the object of this node and the way to enumerate its S_ptr,
+         * and joins the list of objects examined by the collector if there
+         * is one. Called when an S_ptr takes ownership of the object, so
+         * that blocks never shared, e.g. pooled slots owned by a U_ptr,
+         * are never examined.
+         * @param object can be nullptr.
+         * @param trace can be nullptr for objects without S_ptr, which
+         *        cannot be part of a cycle.
+         */
+        void link(void* object, Trace trace) noexcept
+        {
+            _object = object;
+            _trace = object != nullptr ? trace : nullptr;
+            if (_trace == nullptr || tracked())
+            {
+                return;
+            }
+
+            InterruptGuard guard{ };
+            _next = head();
+            if (_next != nullptr)
+            {
+                _next->_previous = this;
+            }
+            head() = this;
+            size()++;
+        }
+
+    protected:
+        CycleNode(void) = default;
+
+        /**
+         * Leaves the list of objects examined by the collector, if linked.
+         * Called when the object is about to be destroyed.
+         */
+        void untrack(void)
+        {
+            if (!tracked())
+            {
+                return;
+            }
+
+            InterruptGuard guard{ };
+            if (cursor() == this)
+            {
+                cursor() = _next;
+            }
+
+            if (_previous != nullptr)
+            {
+                _previous->_next = _next;
+            }
+            else
+            {
+                head() = _next;
+            }
+
+            if (_next != nullptr)
+            {
+                _next->_previous = _previous;
+            }
+            _next = nullptr;
+            _previous = nullptr;
+            size()--;
+        }
+
+    private:
+        using Node = CycleNode<Count, Collected<Lock>>;
+
+        // States of a node during a collection.
+        enum class Color : uint8_t
+        {
+            BLACK,      // Not examined, or in use.
+            GRAY,       // Reachable from the candidate root.
+            LIVE        // Reachable from outside of the candidate's graph.
+        };
+
+        Node* _next{ };
+        Node* _previous{ };
+        Node* _member{ };       // Next node of the candidate's graph.
+        Node* _work{ };         // Next node to mark live, or to free.
+        void* _object{ };
+        Trace _trace{ };
+        Count _external{ };     // References from outside of the graph.
+        Color _color{ Color::BLACK };
+
+        bool tracked(void) const noexcept
+        {
+            return _previous != nullptr || head() == this;
+        }
+
+        static Node*& head(void)
+        {
+            static Node* first{ };
+            return first;
+        }
+
+        // Next candidate root of the collector.
+        static Node*& cursor(void)
+        {
+            static Node* next{ };
+            return next;
+        }
+
+        static size_t& size(void)
+        {
+            static size_t tracked{ };
+            return tracked;
+        }
+    };
+
+    /**
+     * Tells whether U has a trace(visit) member enumerating its S_ptr.
+     */
+    template<typename U, typename Visitor>
+    struct has_trace
+    {
+    private:
+        template<typename V>
+        static auto test(int) -> decltype(static_cast<V*>(nullptr)->trace(*static_cast<Visitor*>(nullptr)), char{ });
+
+        template<typename V>
+        static long test(...);
+
+    public:
+        static constexpr bool value = sizeof(test<U>(0)) == sizeof(char);
+    };
+
+    /**
+     * Type erased call to U::trace(), nullptr if U has none.
+     */
+    template<typename U, typename Visitor, bool Traced = has_trace<U, Visitor>::value>
+    struct TraceOf
+    {
+        static void trace(void* object, Visitor& visit)
+        {
+            static_cast<U*>(object)->trace(visit);
+        }
+
+        static constexpr void (*get(void))(void*, Visitor&)
+        {
+            return &TraceOf<U, Visitor, Traced>::trace;
+        }
+    };
+
+    template<typename U, typename Visitor>
+    struct TraceOf<U, Visitor, false>
+    {
+        static constexpr void (*get(void))(void*, Visitor&)
+        {
+            return nullptr;
+        }
+    };
+
+    /**
+     * Gives a Collected control block its object, once constructed.
+     * Called by the factories.
+     * @param object can be nullptr.
+     */
+    template<typename Count, typename Lock, typename U>
+    void link_cycle_collector(CycleNode<Count, Collected<Lock>>* node, U* object)
+    {
+        node->link(const_cast<void*>(static_cast<const volatile void*>(object)),
+            TraceOf<U, CycleCollector<Count, Collected<Lock>>>::get());
+    }
+
+    template<typename Count, typename Lock>
+    void link_cycle_collector(CycleNode<Count, Lock>*, const volatile void*)
+    {
+        // Not collected.
+    }
+}
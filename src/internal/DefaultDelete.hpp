@@ -0,0 +1,66 @@
+/*
+ ******************************************************************************
+ *  DefaultDelete.hpp
+ *
+ *  Default destruction policy of DuinoMemory smart pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    DefaultDelete destroys objects allocated by new (or by the factories
+ *    heap, see Heap.hpp), and arrays allocated by new[]. Shared by U_ptr
+ *    and by the S_ptr control blocks adopting a raw pointer.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "Heap.hpp"
+#include "Utility.hpp"
+
+namespace DuinoMemory
+{
+    /**
+     * Default destruction policy of U_ptr and of S_ptr adopting a raw
+     * pointer: plain delete.
+     * @param T type of the object to delete.
+     */
+    template<typename T>
+    struct DefaultDelete
+    {
+        DefaultDelete(void) = default;
+
+        /**
+         * Converts the deleter of a derived type, so that U_ptr<Derived>
+         * can be moved to U_ptr<Base>.
+         */
+        template<typename U, typename = typename enable_if<is_convertible<U*, T*>::value>::type>
+        DefaultDelete(const DefaultDelete<U>&) noexcept
+        {
+            // Empty body
+        }
+
+        void operator ()(T* data) const
+        {
+            heap_delete(data);
+        }
+    };
+
+    /**
+     * Default destruction policy for arrays: delete[].
+     * @param T type of the array elements.
+     */
+    template<typename T>
+    struct DefaultDelete<T[]>
+    {
+        void operator ()(T* data) const
+        {
+            delete[] data;
+        }
+    };
+}
@@ -0,0 +1,144 @@
+/*
+ ******************************************************************************
+ *  H_ptr.hpp
+ *
+ *  Checked pointer to an object of a SlotMap.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    H_ptr pairs a SlotMap with a handle, and offers the access operators
+ *    of the other smart pointers. It does not cache the address of its
+ *    object, which SlotMap moves around: every access checks the handle,
+ *    so that an erased object reads as nullptr instead of as whatever now
+ *    lies at its former address.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "SlotMap.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Non-owning pointer to an object of a SlotMap, null once the object
+     * is erased. Copying it is as cheap as copying a raw pointer and a
+     * handle; the object is erased through its SlotMap.
+     * EXAMPLE: H_ptr<Sprite> target{ sprites, sprites.insert() };
+     *          if (target) { target->x += 1; }
+     * CAUTION: the SlotMap must outlive its H_ptr. The address returned by
+     *          get() is only valid until the next erase on the map.
+     * @param T type of the stored objects.
+     * @param Handle handle type of the SlotMap.
+     */
+    template<typename T, typename Handle = uint16_t>
+    class H_ptr final
+    {
+    public:
+        using element_type = T;
+
+        /**
+         * Initializes this H_ptr as nullptr.
+         */
+        H_ptr(void) = default;
+
+        /**
+         * Initializes this H_ptr with an object of map.
+         * @param map holding the object.
+         * @param handle returned by map, can be NONE.
+         */
+        H_ptr(SlotMapBase<T, Handle>& map, Handle handle) noexcept : _map{ &map }, _handle{ handle }
+        {
+            // Empty body
+        }
+
+        /**
+         * @return the object, or nullptr if it was erased.
+         */
+        T* get(void) const noexcept
+        {
+            return _map != nullptr ? _map->get(_handle) : nullptr;
+        }
+
+        /**
+         * Warning:
+         *   Dereferencing a null H_ptr (* or ->) leads to undefined behavior.
+         *   Always check that the pointer is valid before dereferencing:
+         *       if (ptr) { ptr->method(); }
+         */
+        T& operator *(void) const noexcept
+        {
+            return *get();
+        }
+
+        T* operator ->(void) const noexcept
+        {
+            return get();
+        }
+
+        explicit operator bool(void) const noexcept
+        {
+            return get() != nullptr;
+        }
+
+        /**
+         * @return the handle of the object, which stays the same when the
+         *         object moves.
+         */
+        Handle handle(void) const noexcept
+        {
+            return _handle;
+        }
+
+        /**
+         * Makes this H_ptr null. The object is left untouched.
+         */
+        void reset(void) noexcept
+        {
+            _map = nullptr;
+            _handle = SlotMapBase<T, Handle>::NONE;
+        }
+
+        friend bool operator ==(const H_ptr<T, Handle>& a, const H_ptr<T, Handle>& b)
+        {
+            return a.get() == b.get();
+        }
+
+        friend bool operator !=(const H_ptr<T, Handle>& a, const H_ptr<T, Handle>& b)
+        {
+            return a.get() != b.get();
+        }
+
+        friend bool operator ==(const H_ptr<T, Handle>& hp, const T* p)
+        {
+            return hp.get() == p;
+        }
+
+        friend bool operator ==(const T* p, const H_ptr<T, Handle>& hp)
+        {
+            return hp.get() == p;
+        }
+
+        friend bool operator !=(const H_ptr<T, Handle>& hp, const T* p)
+        {
+            return hp.get() != p;
+        }
+
+        friend bool operator !=(const T* p, const H_ptr<T, Handle>& hp)
+        {
+            return hp.get() != p;
+        }
+
+    private:
+        SlotMapBase<T, Handle>* _map{ };
+        Handle _handle{ };
+    };
+}
@@ -0,0 +1,168 @@
+/*
+ ******************************************************************************
+ *  Heap.hpp
+ *
+ *  Memory used by the DuinoMemory factories and control blocks.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    make_unique, make_shared and the S_ptr control blocks allocate through
+ *    the functions below. By default they use the platform new and delete.
+ *    When DUINOMEMORY_TLSF_SIZE is defined before including DuinoMemory.hpp,
+ *    they use a Tlsf allocator over a static region of that many bytes
+ *    instead, for constant time allocation. Objects allocated elsewhere,
+ *    e.g. adopted raw pointers, are recognized by their address and still
+ *    released with delete.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include <stddef.h>
+#include "Locks.hpp"
+#include "Tlsf.hpp"
+#include "Utility.hpp"
+
+#if defined(__AVR__)
+#include <new.h>
+#else
+#include <new>
+#endif
+
+namespace DuinoMemory
+{
+#if defined(DUINOMEMORY_TLSF_SIZE)
+    using DefaultHeap = Tlsf<DUINOMEMORY_TLSF_SIZE>;
+
+    /**
+     * @return the region shared by all factories. Its calls are made with
+     *         interrupts masked, for a bounded time.
+     */
+    inline DefaultHeap& default_heap(void)
+    {
+        static DefaultHeap heap{ };
+        return heap;
+    }
+
+    /**
+     * @param size in bytes.
+     * @return raw memory from the default heap, or nullptr if it is full.
+     */
+    inline void* heap_allocate(size_t size)
+    {
+        auto& heap = default_heap();
+        InterruptGuard guard{ };
+        return heap.allocate(size);
+    }
+
+    /**
+     * Releases memory from heap_allocate(), or from the platform new.
+     * @param memory can be nullptr.
+     */
+    inline void heap_deallocate(void* memory)
+    {
+        auto& heap = default_heap();
+        if (heap.owns(memory))
+        {
+            InterruptGuard guard{ };
+            heap.deallocate(memory);
+        }
+        else
+        {
+            ::operator delete(memory);
+        }
+    }
+#else
+    inline void* heap_allocate(size_t size)
+    {
+        return ::operator new(size);
+    }
+
+    inline void heap_deallocate(void* memory)
+    {
+        ::operator delete(memory);
+    }
+#endif
+
+    /**
+     * Creates a value initialized T on the heap.
+     * @return the new object, or nullptr if allocation failed.
+     */
+    template<typename T>
+    T* heap_new(void)
+    {
+#if defined(DUINOMEMORY_TLSF_SIZE)
+        auto memory = heap_allocate(sizeof(T));
+        return memory != nullptr ? ::new (memory) T{ } : nullptr;
+#else
+        return new T{ };
+#endif
+    }
+
+    /**
+     * Creates a T on the heap.
+     * @param args must match one of T's constructors.
+     * @return the new object, or nullptr if allocation failed.
+     */
+    template<typename T, class... Args>
+    T* heap_new(Args&&... args)
+    {
+#if defined(DUINOMEMORY_TLSF_SIZE)
+        auto memory = heap_allocate(sizeof(T));
+        return memory != nullptr ? ::new (memory) T(DuinoMemory::forward<Args>(args)...) : nullptr;
+#else
+        return new T(DuinoMemory::forward<Args>(args)...);
+#endif
+    }
+
+    /**
+     * Start of the most derived object pointed to by data, i.e. of its
+     * allocation. A base other than the first one of a class is found
+     * further in, which only the vtable tells: dynamic_cast to void*
+     * reads it, and does not need RTTI.
+     */
+    template<typename T, bool Polymorphic = __is_polymorphic(T)>
+    struct ObjectStart
+    {
+        static void* of(T* data) noexcept
+        {
+            return const_cast<void*>(static_cast<const volatile void*>(data));
+        }
+    };
+
+    template<typename T>
+    struct ObjectStart<T, true>
+    {
+        static void* of(T* data) noexcept
+        {
+            return const_cast<void*>(dynamic_cast<const volatile void*>(data));
+        }
+    };
+
+    /**
+     * Destroys an object created by heap_new, or by the platform new.
+     * @param data can be nullptr, or point to any base of the object if
+     *        its destructor is virtual.
+     */
+    template<typename T>
+    void heap_delete(T* data)
+    {
+#if defined(DUINOMEMORY_TLSF_SIZE)
+        if (data != nullptr && default_heap().owns(data))
+        {
+            // Read before the destructor resets the vtable.
+            auto memory = ObjectStart<T>::of(data);
+            data->~T();
+            heap_deallocate(memory);
+            return;
+        }
+#endif
+        delete data;
+    }
+}
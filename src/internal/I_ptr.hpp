@@ -0,0 +1,231 @@
+/*
+ ******************************************************************************
+ *  I_ptr.hpp
+ *
+ *  Intrusive reference counted pointer for Arduino.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    I_ptr shares ownership like S_ptr, but the reference count lives in
+ *    the object itself, through the RefCounted base class. The handle is
+ *    the size of a raw pointer and no control block is ever allocated.
+ *    Since the count travels with the object, a raw pointer (this
+ *    included) can safely be wrapped in a new I_ptr.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "SmartPointer.hpp"
+#include "Heap.hpp"
+#include "Locks.hpp"
+#include "Utility.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    template<typename T>
+    class I_ptr;
+
+    /**
+     * Base class embedding the reference count used by I_ptr.
+     * EXAMPLE: class Task : public DuinoMemory::RefCounted<>
+     *          {
+     *              ...
+     *          };
+     * @param Count unsigned integer type of the reference count. Counts
+     *        saturate: once at their maximum value, the object is never
+     *        destroyed.
+     * @param Lock policy protecting reference count updates (see Locks.hpp).
+     */
+    template<typename Count = size_t, typename Lock = InterruptLock>
+    class RefCounted
+    {
+        template<typename T>
+        friend class I_ptr;
+
+    public:
+        /**
+         * @return the number of I_ptr referencing this object.
+         */
+        size_t ref_count(void) const noexcept
+        {
+            return _ref_count;
+        }
+
+    protected:
+        RefCounted(void) = default;
+
+        // A copy is a new object: it starts without any reference.
+        RefCounted(const RefCounted<Count, Lock>&) : _ref_count{ }
+        {
+            // Empty body
+        }
+
+        // References belong to each object and are never assigned.
+        RefCounted<Count, Lock>& operator =(const RefCounted<Count, Lock>&)
+        {
+            return *this;
+        }
+
+        ~RefCounted(void) = default;
+
+    private:
+        mutable Count _ref_count{ };
+
+        void add_reference(void) const
+        {
+            Lock::increment(_ref_count);
+        }
+
+        // @return true if the last reference was dropped.
+        bool drop_reference(void) const
+        {
+            return Lock::decrement(_ref_count) == 0;
+        }
+    };
+
+    /**
+     * Pointer sharing ownership of an object deriving from RefCounted.
+     * The object is deleted when its last I_ptr goes away.
+     * @param T must derive publicly from RefCounted. CAUTION: as a base type,
+     *        T must have a virtual destructor, otherwise deleting the base
+     *        pointer may lead to undefined behavior and cause memory leaks
+     *        or crashes. Objects must be allocated with new or by
+     *        make_intrusive, never on the stack or as globals.
+     */
+    template<typename T>
+    class I_ptr final : public SmartPointer<T>
+    {
+    public:
+        /**
+         * Initializes this I_ptr as nullptr.
+         */
+        I_ptr(void) = default;
+
+        /**
+         * Initializes this I_ptr with the provided pointer, adding one
+         * reference to the object. Unlike S_ptr, data may already be owned
+         * by other I_ptr: it can come from get(), or be this.
+         * @param data can be nullptr.
+         */
+        explicit I_ptr(T* data) : SmartPointer<T>{ data }
+        {
+            acquire(data);
+        }
+
+        I_ptr(const I_ptr<T>& other) : SmartPointer<T>{ other.get() }
+        {
+            acquire(other.get());
+        }
+
+        /**
+         * Takes over the reference held by other, leaving it null.
+         * The reference count is not modified.
+         */
+        I_ptr(I_ptr<T>&& other) noexcept : SmartPointer<T>{ other.get() }
+        {
+            other.set_data(nullptr);
+        }
+
+        ~I_ptr(void)
+        {
+            release();
+        }
+
+        /**
+         * @return the number of I_ptr referencing the object, 0 if nullptr.
+         */
+        size_t count(void) const noexcept
+        {
+            auto data = SmartPointer<T>::get();
+            return data != nullptr ? data->ref_count() : 0;
+        }
+
+        /**
+         * Adds one reference to data, which may already be owned by other
+         * I_ptr, and drops the current one.
+         */
+        I_ptr<T>& operator =(T* data_ptr)
+        {
+            if (data_ptr != SmartPointer<T>::get())
+            {
+                acquire(data_ptr);
+                release();
+                SmartPointer<T>::set_data(data_ptr);
+            }
+            return *this;
+        }
+
+        I_ptr<T>& operator =(const I_ptr<T>& other)
+        {
+            return *this = other.get();
+        }
+
+        I_ptr<T>& operator =(I_ptr<T>&& other) noexcept
+        {
+            // Avoid self assignment.
+            if (this != &other)
+            {
+                release();
+                SmartPointer<T>::set_data(other.get());
+                other.set_data(nullptr);
+            }
+            return *this;
+        }
+
+    private:
+        static void acquire(T* data)
+        {
+            if (data != nullptr)
+            {
+                data->add_reference();
+            }
+        }
+
+        void release(void)
+        {
+            auto data = SmartPointer<T>::get();
+            SmartPointer<T>::set_data(nullptr);
+
+            if (data != nullptr && data->drop_reference())
+            {
+                heap_delete(data);
+            }
+        }
+    };
+
+    /**
+     * Creates an instance of T with the provided arguments, owned by an I_ptr.
+     * No allocation besides the object itself occurs.
+     * @param T must derive from RefCounted.
+     * @param args must match one of T's constructors.
+     * @return a new I_ptr<T> wrapping the newly instanced T.
+     */
+    template<typename T, class... Args>
+    I_ptr<T> make_intrusive(Args&&... args)
+    {
+        return I_ptr<T>{ heap_new<T>(DuinoMemory::forward<Args>(args)...) };
+    }
+
+    /**
+     * Creates an instance of U with the provided arguments, owned by an I_ptr<T>.
+     * @param T must derive from RefCounted. CAUTION: as a base type, T must have
+     *        a virtual destructor, otherwise deleting the base pointer may lead to
+     *        undefined behavior and cause memory leaks or crashes.
+     * @param U is a derived type of T.
+     * @param args must match one of U's constructors.
+     * @return a new I_ptr<T> wrapping the newly instanced U.
+     */
+    template<typename T, typename U, class... Args>
+    I_ptr<T> make_intrusive(Args&&... args)
+    {
+        return I_ptr<T>{ heap_new<U>(DuinoMemory::forward<Args>(args)...) };
+    }
+}
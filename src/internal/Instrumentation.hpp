@@ -0,0 +1,271 @@
+/*
+ ******************************************************************************
+ *  Instrumentation.hpp
+ *
+ *  Optional allocation statistics for DuinoMemory smart pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    When DUINOMEMORY_INSTRUMENTATION is defined before including
+ *    DuinoMemory.hpp, heap objects owned by U_ptr and S_ptr are counted
+ *    per type: live objects, live bytes, peak bytes and allocations.
+ *    Otherwise every hook is empty and compiles to nothing.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "Locks.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Statistics of the heap objects of one type, or of all types.
+     */
+    struct AllocationStats
+    {
+        const char* name;           // Type name, not null terminated.
+        size_t name_length;
+        size_t live;                // Objects currently owned.
+        size_t live_bytes;          // Bytes currently owned, blocks included.
+        size_t peak_bytes;          // Highest value of live_bytes.
+        size_t allocations;         // Objects created so far.
+        AllocationStats* next;      // Next registered type.
+    };
+
+    /**
+     * Size of T as counted by the statistics: arrays of unknown bound
+     * count for 0 byte, as their length is not known.
+     */
+    template<typename T>
+    struct tracked_size
+    {
+        static constexpr size_t value = sizeof(T);
+    };
+
+    template<typename T>
+    struct tracked_size<T[]>
+    {
+        static constexpr size_t value = 0;
+    };
+
+#if defined(DUINOMEMORY_INSTRUMENTATION)
+    /**
+     * Registry of the per type statistics, chained in order of first use.
+     */
+    class Instrumentation final
+    {
+    public:
+        /**
+         * @return the statistics of all types together.
+         */
+        static AllocationStats& total(void)
+        {
+            static AllocationStats stats{ "total", 5, 0, 0, 0, 0, nullptr };
+            return stats;
+        }
+
+        /**
+         * @return the first registered type, nullptr if none.
+         */
+        static AllocationStats*& first(void)
+        {
+            static AllocationStats* head{ };
+            return head;
+        }
+
+        /**
+         * @param T type of the objects.
+         * @return the statistics of T, registered on first call.
+         */
+        template<typename T>
+        static AllocationStats& of(void)
+        {
+            static AllocationStats stats{ };
+            if (stats.name == nullptr)
+            {
+                InterruptGuard guard{ };
+                if (stats.name == nullptr)
+                {
+                    name_of<T>(stats);
+                    stats.next = first();
+                    first() = &stats;
+                }
+            }
+            return stats;
+        }
+
+        static void allocated(AllocationStats& stats, size_t bytes)
+        {
+            stats.live++;
+            stats.live_bytes += bytes;
+            stats.allocations++;
+            if (stats.live_bytes > stats.peak_bytes)
+            {
+                stats.peak_bytes = stats.live_bytes;
+            }
+        }
+
+        static void released(AllocationStats& stats, size_t bytes)
+        {
+            stats.live--;
+            stats.live_bytes -= bytes;
+        }
+
+        // Same as allocated(), without counting a new allocation.
+        static void received(AllocationStats& stats, size_t bytes)
+        {
+            stats.allocations--;
+            allocated(stats, bytes);
+        }
+
+    private:
+        // Extracts T from the compiler generated function signature,
+        // e.g. "... name_of(AllocationStats&) [with T = Route]".
+        template<typename T>
+        static void name_of(AllocationStats& stats)
+        {
+            const char* signature = __PRETTY_FUNCTION__;
+            const char* start = signature;
+            for (auto c = signature; *c != '\0'; c++)
+            {
+                if (c[0] == 'T' && c[1] == ' ' && c[2] == '=' && c[3] == ' ')
+                {
+                    start = c + 4;
+                    break;
+                }
+            }
+
+            // Up to the closing bracket, not one of an array type.
+            auto end = start;
+            while (*end != '\0' && *end != ';')
+            {
+                end++;
+            }
+            if (*end == '\0' && end > start && end[-1] == ']')
+            {
+                end--;
+            }
+
+            stats.name = start;
+            stats.name_length = static_cast<size_t>(end - start);
+        }
+    };
+
+    /**
+     * Records the creation of a heap object of type T.
+     * @param bytes allocated for it, control block included.
+     */
+    template<typename T>
+    inline void record_allocation(size_t bytes)
+    {
+        auto& stats = Instrumentation::of<T>();
+        InterruptGuard guard{ };
+        Instrumentation::allocated(stats, bytes);
+        Instrumentation::allocated(Instrumentation::total(), bytes);
+    }
+
+    /**
+     * Records the release of a heap object of type T.
+     * @param bytes given to record_allocation for it.
+     */
+    template<typename T>
+    inline void record_release(size_t bytes)
+    {
+        auto& stats = Instrumentation::of<T>();
+        InterruptGuard guard{ };
+        Instrumentation::released(stats, bytes);
+        Instrumentation::released(Instrumentation::total(), bytes);
+    }
+
+    /**
+     * Records that a heap object counted as a From is now owned as a To,
+     * e.g. after moving a U_ptr<Derived> to a U_ptr<Base>.
+     * @param from_bytes given to record_allocation for it.
+     * @param to_bytes counted from now on.
+     */
+    template<typename From, typename To>
+    inline void record_transfer(size_t from_bytes, size_t to_bytes)
+    {
+        auto& from = Instrumentation::of<From>();
+        auto& to = Instrumentation::of<To>();
+        InterruptGuard guard{ };
+        Instrumentation::released(from, from_bytes);
+        Instrumentation::received(to, to_bytes);
+        Instrumentation::released(Instrumentation::total(), from_bytes);
+        Instrumentation::received(Instrumentation::total(), to_bytes);
+    }
+
+    /**
+     * Calls visit with a snapshot of the totals, then of each type.
+     * EXAMPLE (host): for_each_stats([](const AllocationStats& s) { ... });
+     * @param visit callable taking a const AllocationStats&.
+     */
+    template<typename Visitor>
+    void for_each_stats(Visitor visit)
+    {
+        AllocationStats snapshot;
+        {
+            InterruptGuard guard{ };
+            snapshot = Instrumentation::total();
+        }
+        visit(snapshot);
+
+        for (auto stats = Instrumentation::first(); stats != nullptr; stats = snapshot.next)
+        {
+            {
+                InterruptGuard guard{ };
+                snapshot = *stats;
+            }
+            visit(snapshot);
+        }
+    }
+
+    /**
+     * Prints one line per type, totals first:
+     * "<type> live=<objects> bytes=<live bytes> peak=<bytes> allocs=<count>"
+     * @param out any Arduino Print, such as Serial.
+     */
+    template<typename Output>
+    void dump_stats(Output& out)
+    {
+        for_each_stats([&out](const AllocationStats& stats) {
+            out.write(reinterpret_cast<const uint8_t*>(stats.name), stats.name_length);
+            out.print(" live=");
+            out.print(static_cast<unsigned long>(stats.live));
+            out.print(" bytes=");
+            out.print(static_cast<unsigned long>(stats.live_bytes));
+            out.print(" peak=");
+            out.print(static_cast<unsigned long>(stats.peak_bytes));
+            out.print(" allocs=");
+            out.println(static_cast<unsigned long>(stats.allocations));
+        });
+    }
+#else
+    template<typename T>
+    inline void record_allocation(size_t)
+    {
+        // Instrumentation disabled.
+    }
+
+    template<typename T>
+    inline void record_release(size_t)
+    {
+        // Instrumentation disabled.
+    }
+
+    template<typename From, typename To>
+    inline void record_transfer(size_t, size_t)
+    {
+        // Instrumentation disabled.
+    }
+#endif
+}
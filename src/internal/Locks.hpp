@@ -0,0 +1,333 @@
+/*
+ ******************************************************************************
+ *  Locks.hpp
+ *
+ *  Concurrency policies for DuinoMemory reference counting.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    A lock policy defines how reference counts are updated: without any
+ *    protection, with interrupts masked, with atomic instructions or
+ *    under a mutex. Each policy provides the same static functions, so
+ *    that S_ptr only pays for the protection it actually needs.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * @param Count unsigned integer type of the reference counts.
+     * @return the count value at which references stop being counted.
+     */
+    template<typename Count>
+    constexpr Count saturated_count(void)
+    {
+        return static_cast<Count>(-1);
+    }
+
+    /**
+     * Critical section doing nothing. For objects only ever used from a
+     * single context (no ISR, no other task).
+     */
+    class NoGuard
+    {
+    public:
+        NoGuard(void)
+        {
+            // Empty body
+        }
+    };
+
+    /**
+     * Critical section masking interrupts for its lifetime, then restoring
+     * the interrupt state found on construction. Nesting is therefore safe,
+     * including from ISRs. Uses SREG on AVR, PRIMASK on ARM Cortex-M, the
+     * PS register on ESP8266 and the FreeRTOS port on ESP32 and other
+     * FreeRTOS targets.
+     * CAUTION: on any other target, falls back to noInterrupts() /
+     *          interrupts() and always re-enables them. Masking interrupts
+     *          does not protect against other cores.
+     */
+    class InterruptGuard
+    {
+    public:
+#if defined(__AVR__)
+        InterruptGuard(void) : _state{ SREG }
+        {
+            cli();
+        }
+
+        ~InterruptGuard(void)
+        {
+            // Keeps the accesses of the critical section before the restore.
+            __asm__ volatile ("" : : : "memory");
+            SREG = _state;
+        }
+
+    private:
+        uint8_t _state;
+#elif defined(__arm__) && (defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__))
+        InterruptGuard(void)
+        {
+            __asm__ volatile ("mrs %0, primask" : "=r" (_state));
+            __asm__ volatile ("cpsid i" : : : "memory");
+        }
+
+        ~InterruptGuard(void)
+        {
+            __asm__ volatile ("msr primask, %0" : : "r" (_state) : "memory");
+        }
+
+    private:
+        uint32_t _state;
+#elif defined(ESP8266)
+        InterruptGuard(void) : _state{ xt_rsil(15) }
+        {
+            // Empty body
+        }
+
+        ~InterruptGuard(void)
+        {
+            xt_wsr_ps(_state);
+        }
+
+    private:
+        uint32_t _state;
+#elif defined(portSET_INTERRUPT_MASK_FROM_ISR)
+        // Only masks the interrupts of the current core.
+        InterruptGuard(void) : _state{ portSET_INTERRUPT_MASK_FROM_ISR() }
+        {
+            // Empty body
+        }
+
+        ~InterruptGuard(void)
+        {
+            portCLEAR_INTERRUPT_MASK_FROM_ISR(_state);
+        }
+
+    private:
+        decltype(portSET_INTERRUPT_MASK_FROM_ISR()) _state;
+#else
+        InterruptGuard(void)
+        {
+            noInterrupts();
+        }
+
+        ~InterruptGuard(void)
+        {
+            interrupts();
+        }
+#endif
+
+    public:
+        InterruptGuard(const InterruptGuard& other) = delete;
+        InterruptGuard& operator =(const InterruptGuard& other) = delete;
+    };
+
+    /**
+     * Critical section holding a mutex for its lifetime.
+     * @param Mutex type providing static lock() and unlock() functions.
+     *        EXAMPLE (FreeRTOS):
+     *          struct CountMutex
+     *          {
+     *              static SemaphoreHandle_t handle;
+     *              static void lock(void) { xSemaphoreTake(handle, portMAX_DELAY); }
+     *              static void unlock(void) { xSemaphoreGive(handle); }
+     *          };
+     */
+    template<typename Mutex>
+    class MutexGuard
+    {
+    public:
+        MutexGuard(void)
+        {
+            Mutex::lock();
+        }
+
+        ~MutexGuard(void)
+        {
+            Mutex::unlock();
+        }
+
+        MutexGuard(const MutexGuard<Mutex>& other) = delete;
+        MutexGuard<Mutex>& operator =(const MutexGuard<Mutex>& other) = delete;
+    };
+
+    /**
+     * Lock policy updating counts with plain arithmetic inside a critical
+     * section. Counts saturate at their maximum value.
+     * @param Guard type of critical section, held during each update.
+     */
+    template<typename Guard>
+    struct GuardedLock
+    {
+        using guard_type = Guard;
+
+        /**
+         * Increments count, unless saturated.
+         */
+        template<typename Count>
+        static void increment(Count& count)
+        {
+            Guard guard{ };
+            if (count != saturated_count<Count>())
+            {
+                count++;
+            }
+        }
+
+        /**
+         * Increments count, unless saturated or 0.
+         * @return false if count was 0.
+         */
+        template<typename Count>
+        static bool increment_if_alive(Count& count)
+        {
+            Guard guard{ };
+            if (count == 0)
+            {
+                return false;
+            }
+
+            if (count != saturated_count<Count>())
+            {
+                count++;
+            }
+            return true;
+        }
+
+        /**
+         * Decrements count, unless saturated.
+         * @return the new value of count.
+         */
+        template<typename Count>
+        static Count decrement(Count& count)
+        {
+            Guard guard{ };
+            if (count != saturated_count<Count>())
+            {
+                count--;
+            }
+            return count;
+        }
+    };
+
+    /**
+     * No protection at all: the cheapest policy, for objects shared within
+     * a single context.
+     */
+    using NoLock = GuardedLock<NoGuard>;
+
+    /**
+     * Masks interrupts around each update, restoring their previous state.
+     * Default policy, suitable for objects shared with ISRs on single core
+     * targets.
+     */
+    using InterruptLock = GuardedLock<InterruptGuard>;
+
+    /**
+     * Holds a mutex around each update. For objects shared between RTOS
+     * tasks.
+     * @param Mutex type providing static lock() and unlock() functions.
+     */
+    template<typename Mutex>
+    using MutexLock = GuardedLock<MutexGuard<Mutex>>;
+
+    /**
+     * Atomic updates of a count narrower than a pointer, which could reach
+     * its maximum value: compare and swap loops, so that it saturates.
+     */
+    template<typename Count, bool Wide = sizeof(Count) >= sizeof(void*)>
+    struct AtomicCount
+    {
+        static void increment(Count& count)
+        {
+            auto current = __atomic_load_n(&count, __ATOMIC_RELAXED);
+            while (current != saturated_count<Count>()
+                && !__atomic_compare_exchange_n(&count, &current, static_cast<Count>(current + 1), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                // current was updated, try again.
+            }
+        }
+
+        static Count decrement(Count& count)
+        {
+            auto current = __atomic_load_n(&count, __ATOMIC_RELAXED);
+            while (current != saturated_count<Count>())
+            {
+                auto next = static_cast<Count>(current - 1);
+                if (__atomic_compare_exchange_n(&count, &current, next, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                {
+                    return next;
+                }
+            }
+            return current;
+        }
+    };
+
+    /**
+     * Atomic updates of a count at least as wide as a pointer. Every
+     * reference takes some memory, so such a count never gets near its
+     * maximum value: a single fetch and add is enough.
+     */
+    template<typename Count>
+    struct AtomicCount<Count, true>
+    {
+        static void increment(Count& count)
+        {
+            __atomic_fetch_add(&count, 1, __ATOMIC_RELAXED);
+        }
+
+        static Count decrement(Count& count)
+        {
+            return static_cast<Count>(__atomic_fetch_sub(&count, 1, __ATOMIC_ACQ_REL) - 1);
+        }
+    };
+
+    /**
+     * Updates counts with atomic instructions, without masking interrupts.
+     * For multi-core targets like the ESP32, or hosts. Counts as wide as a
+     * pointer use fetch and add, narrower ones compare and swap.
+     * CAUTION: requires hardware atomics for Count (not available on AVR).
+     */
+    struct AtomicLock
+    {
+        template<typename Count>
+        static void increment(Count& count)
+        {
+            AtomicCount<Count>::increment(count);
+        }
+
+        template<typename Count>
+        static bool increment_if_alive(Count& count)
+        {
+            auto current = __atomic_load_n(&count, __ATOMIC_RELAXED);
+            while (current != 0)
+            {
+                if (current == saturated_count<Count>()
+                    || __atomic_compare_exchange_n(&count, &current, static_cast<Count>(current + 1), true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template<typename Count>
+        static Count decrement(Count& count)
+        {
+            return AtomicCount<Count>::decrement(count);
+        }
+    };
+}
@@ -0,0 +1,297 @@
+/*
+ ******************************************************************************
+ *  ObjectPool.hpp
+ *
+ *  Fixed capacity object pool for DuinoMemory smart pointers.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    ObjectPool carves a statically sized array into N slots, each able to
+ *    hold one object. make_pooled and make_pooled_shared hand out U_ptr and
+ *    S_ptr whose objects return to the pool instead of being deleted.
+ *    Allocating and freeing a slot never touches the heap and takes
+ *    constant time.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "U_ptr.hpp"
+#include "S_ptr.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    template<typename T>
+    class PoolBase;
+
+    template<typename T>
+    struct PoolLayout;
+
+    /**
+     * Control block stored right after each pooled object. Keeps track of
+     * the pool owning the slot, and of the reference count when the object
+     * is shared through S_ptr.
+     * @param T type of the pooled objects.
+     */
+    template<typename T>
+    class PoolBlock final : public ControlBlock<typename SharedTraits<T>::count_type, typename SharedTraits<T>::lock_type>
+    {
+        using Base = ControlBlock<typename SharedTraits<T>::count_type, typename SharedTraits<T>::lock_type>;
+
+    public:
+        /**
+         * Initializes this PoolBlock with the pool owning its slot.
+         * @param pool cannot be nullptr.
+         */
+        explicit PoolBlock(PoolBase<T>* pool) : Base{ &PoolBlock<T>::manage }, _pool{ pool }
+        {
+            // Empty body
+        }
+
+        /**
+         * @param object pointer to a pooled object. Cannot be nullptr.
+         * @return the PoolBlock of the slot holding object.
+         */
+        static PoolBlock<T>* of(T* object)
+        {
+            auto slot = reinterpret_cast<unsigned char*>(object);
+            return reinterpret_cast<PoolBlock<T>*>(slot + PoolLayout<T>::BLOCK_OFFSET);
+        }
+
+        /**
+         * Destroys the pooled object and returns its slot to the pool.
+         * @param object cannot be nullptr.
+         */
+        static void recycle(T* object)
+        {
+            auto block = of(object);
+            auto pool = block->_pool;
+
+            // The free list overwrites the block: leave the collector first.
+            block->untrack();
+            object->~T();
+            pool->give_back(reinterpret_cast<unsigned char*>(object));
+        }
+
+    private:
+        PoolBase<T>* _pool;
+
+        static void manage(Base* block, BlockOperation operation)
+        {
+            auto slot = reinterpret_cast<unsigned char*>(block) - PoolLayout<T>::BLOCK_OFFSET;
+            if (operation == BlockOperation::DISPOSE)
+            {
+                reinterpret_cast<T*>(slot)->~T();
+            }
+            else
+            {
+                static_cast<PoolBlock<T>*>(block)->_pool->give_back(slot);
+            }
+        }
+    };
+
+    /**
+     * Memory layout of a pool slot: the object first, so that a pointer
+     * to the object is a pointer to its slot, then its PoolBlock.
+     * @param T type of the pooled objects.
+     */
+    template<typename T>
+    struct PoolLayout
+    {
+        static constexpr size_t ALIGNMENT = alignof(T) > alignof(PoolBlock<T>) ? alignof(T) : alignof(PoolBlock<T>);
+        static constexpr size_t BLOCK_OFFSET = (sizeof(T) + alignof(PoolBlock<T>) - 1) / alignof(PoolBlock<T>) * alignof(PoolBlock<T>);
+        static constexpr size_t SLOT_SIZE = (BLOCK_OFFSET + sizeof(PoolBlock<T>) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    };
+
+    /**
+     * Deleter returning U_ptr owned objects to their ObjectPool.
+     * Stateless, so that a pooled U_ptr is not bigger than a regular one.
+     * @param T type of the pooled objects.
+     */
+    template<typename T>
+    struct PoolDelete
+    {
+        void operator ()(T* data) const
+        {
+            PoolBlock<T>::recycle(data);
+        }
+    };
+
+    /**
+     * Capacity independent part of ObjectPool: free slots management.
+     * @param T type of the pooled objects.
+     */
+    template<typename T>
+    class PoolBase
+    {
+        friend class PoolBlock<T>;
+
+    public:
+        PoolBase(const PoolBase<T>& other) = delete;
+        PoolBase<T>& operator =(const PoolBase<T>& other) = delete;
+
+        /**
+         * @return the number of slots currently holding an object.
+         */
+        size_t in_use(void) const noexcept
+        {
+            return _in_use;
+        }
+
+    protected:
+        PoolBase(void) = default;
+        ~PoolBase(void) = default;
+
+        /**
+         * Takes a free slot, preferably one that has already been used.
+         * @param storage first slot of the pool.
+         * @param capacity number of slots in storage.
+         * @return the slot, with its PoolBlock initialized, or nullptr if
+         *         the pool is exhausted.
+         */
+        unsigned char* take(unsigned char* storage, size_t capacity)
+        {
+            auto slot = _free;
+            if (slot != nullptr)
+            {
+                _free = next_of(slot);
+            }
+            else if (_untouched < capacity)
+            {
+                slot = storage + _untouched * PoolLayout<T>::SLOT_SIZE;
+                _untouched++;
+            }
+            else
+            {
+                return nullptr;
+            }
+
+            ::new (static_cast<void*>(slot + PoolLayout<T>::BLOCK_OFFSET)) PoolBlock<T>{ this };
+            _in_use++;
+            return slot;
+        }
+
+    private:
+        // Free slots are chained through their PoolBlock area.
+        unsigned char* _free{ };
+        size_t _untouched{ };
+        size_t _in_use{ };
+
+        void give_back(unsigned char* slot)
+        {
+            next_of(slot) = _free;
+            _free = slot;
+            _in_use--;
+        }
+
+        static unsigned char*& next_of(unsigned char* slot)
+        {
+            return *reinterpret_cast<unsigned char**>(slot + PoolLayout<T>::BLOCK_OFFSET);
+        }
+    };
+
+    /**
+     * Pool of N slots for objects of type T. Declare it as a global or
+     * static variable so that its storage is reserved at link time.
+     * Objects are handed out by make_pooled and make_pooled_shared.
+     * CAUTION: the pool must outlive every pointer it handed out, and is
+     *          not safe to use from ISRs.
+     * @param T type of the pooled objects. Each slot also holds a small
+     *          control block (count, destroy function and pool pointer).
+     * @param N number of slots.
+     */
+    template<typename T, size_t N>
+    class ObjectPool final : public PoolBase<T>
+    {
+        static_assert(N > 0, "ObjectPool must have at least one slot");
+
+    public:
+        /**
+         * Initializes this ObjectPool with all slots free. Does not touch
+         * the slots themselves.
+         */
+        ObjectPool(void) = default;
+
+        /**
+         * @return the total number of slots.
+         */
+        constexpr size_t capacity(void) const noexcept
+        {
+            return N;
+        }
+
+        /**
+         * @return the number of free slots.
+         */
+        size_t available(void) const noexcept
+        {
+            return N - PoolBase<T>::in_use();
+        }
+
+        /**
+         * Constructs an object in a free slot.
+         * @param args must match one of T's constructors.
+         * @return the new object, or nullptr if the pool is exhausted.
+         */
+        template<class... Args>
+        T* create(Args&&... args)
+        {
+            auto slot = PoolBase<T>::take(_storage, N);
+            return slot != nullptr ? ::new (static_cast<void*>(slot)) T(DuinoMemory::forward<Args>(args)...) : nullptr;
+        }
+
+        /**
+         * Value initializes an object in a free slot.
+         * @return the new object, or nullptr if the pool is exhausted.
+         */
+        T* create(void)
+        {
+            auto slot = PoolBase<T>::take(_storage, N);
+            return slot != nullptr ? ::new (static_cast<void*>(slot)) T{ } : nullptr;
+        }
+
+    private:
+        alignas(PoolLayout<T>::ALIGNMENT) unsigned char _storage[N * PoolLayout<T>::SLOT_SIZE];
+    };
+
+    /**
+     * Creates an object in pool, owned by a U_ptr that returns it to
+     * the pool when destroyed.
+     * @param T type of the object.
+     * @param pool to take the slot from.
+     * @param args must match one of T's constructors.
+     * @return a new U_ptr, or nullptr if the pool is exhausted.
+     */
+    template<typename T, size_t N, class... Args>
+    U_ptr<T, PoolDelete<T>> make_pooled(ObjectPool<T, N>& pool, Args&&... args)
+    {
+        return U_ptr<T, PoolDelete<T>>{ pool.create(DuinoMemory::forward<Args>(args)...) };
+    }
+
+    /**
+     * Creates an object in pool, shared by S_ptr. The slot's control
+     * block holds the reference count, so no heap allocation occurs.
+     * @param T type of the object.
+     * @param pool to take the slot from.
+     * @param args must match one of T's constructors.
+     * @return a new S_ptr, or nullptr if the pool is exhausted.
+     */
+    template<typename T, size_t N, class... Args>
+    S_ptr<T> make_pooled_shared(ObjectPool<T, N>& pool, Args&&... args)
+    {
+        auto data = pool.create(DuinoMemory::forward<Args>(args)...);
+        if (data == nullptr)
+        {
+            return S_ptr<T>{ };
+        }
+
+        return SharedFactory::from_block<T>(data, PoolBlock<T>::of(data));
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ ******************************************************************************
+ *  Reclaim.hpp
+ *
+ *  Deferred destruction of shared objects.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Objects whose SharedTraits enable deferred destruction are not
+ *    destroyed when their last S_ptr goes away, e.g. in an ISR. Their
+ *    control block is queued instead, and reclaim() destroys them later
+ *    from loop(), within a count or time budget. Queued blocks are chained
+ *    through a link of their own: the queue never fills up and never
+ *    allocates.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "Locks.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Deferred objects of one type of control block, e.g. all blocks with
+     * a size_t count and an InterruptLock. The blocks themselves are
+     * chained, so that any number of them can wait without allocating.
+     */
+    struct ReclaimSource
+    {
+        bool (*reclaim_one)(void);      // Destroys the oldest object, false if none.
+        size_t (*pending)(void);
+        ReclaimSource* next;            // Next registered source.
+        bool registered;
+    };
+
+    /**
+     * Registry of the sources of deferred objects, one per type of control
+     * block in use. Queuing and dequeuing mask interrupts for a few
+     * instructions only.
+     * CAUTION: masking interrupts does not protect against other cores.
+     */
+    class ReclaimQueue final
+    {
+    public:
+        ReclaimQueue(const ReclaimQueue& other) = delete;
+        ReclaimQueue& operator =(const ReclaimQueue& other) = delete;
+
+        /**
+         * @return the registry shared by all deferred objects.
+         */
+        static ReclaimQueue& instance(void)
+        {
+            static ReclaimQueue queue{ };
+            return queue;
+        }
+
+        /**
+         * Registers source, once. Called with its first deferred object.
+         * @param source must live until the end of the program.
+         */
+        void attach(ReclaimSource& source)
+        {
+            InterruptGuard guard{ };
+            if (!source.registered)
+            {
+                source.registered = true;
+                source.next = _first;
+                _first = &source;
+            }
+        }
+
+        /**
+         * Destroys the oldest queued object of the first source holding
+         * one, outside of any critical section.
+         * @return false if no object was waiting.
+         */
+        bool reclaim_one(void)
+        {
+            for (auto source = first(); source != nullptr; source = source->next)
+            {
+                if (source->reclaim_one())
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @return the number of objects waiting for destruction.
+         */
+        size_t pending(void) const
+        {
+            size_t total = 0;
+            for (auto source = first(); source != nullptr; source = source->next)
+            {
+                total += source->pending();
+            }
+            return total;
+        }
+
+    private:
+        ReclaimSource* _first{ };
+
+        ReclaimQueue(void) = default;
+
+        // Sources are only ever prepended: once read, the chain is stable.
+        ReclaimSource* first(void) const
+        {
+            InterruptGuard guard{ };
+            return _first;
+        }
+    };
+
+    /**
+     * Destroys up to budget objects whose destruction was deferred. Call
+     * it from loop(). Objects released by these destructors may be queued
+     * in turn, so that large object graphs are torn down over several
+     * calls.
+     * @param budget maximum number of objects to destroy.
+     * @return the number of objects destroyed.
+     */
+    inline size_t reclaim(size_t budget = static_cast<size_t>(-1))
+    {
+        size_t done = 0;
+        while (done < budget && ReclaimQueue::instance().reclaim_one())
+        {
+            done++;
+        }
+        return done;
+    }
+
+    /**
+     * Destroys deferred objects until the queue is empty or microseconds
+     * have elapsed. The last destructor may exceed the budget.
+     * @param microseconds time budget, measured with micros().
+     * @return the number of objects destroyed.
+     */
+    inline size_t reclaim_for(unsigned long microseconds)
+    {
+        auto start = micros();
+        size_t done = 0;
+        while (micros() - start < microseconds && ReclaimQueue::instance().reclaim_one())
+        {
+            done++;
+        }
+        return done;
+    }
+
+    /**
+     * @return the number of objects waiting for reclaim().
+     */
+    inline size_t reclaim_pending(void)
+    {
+        return ReclaimQueue::instance().pending();
+    }
+}
@@ -0,0 +1,304 @@
+/*
+ ******************************************************************************
+ *  S_buf.hpp
+ *
+ *  Shared, immutable byte buffers with zero-copy slicing.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    S_buf is a view over a range of bytes owned by an S_ptr<uint8_t[]>.
+ *    Copying an S_buf or taking a slice() of it only updates the reference
+ *    count of the underlying array; bytes are never copied. BufChain
+ *    gathers several S_buf, e.g. a header and a payload, and writes them
+ *    one after the other without flattening them first.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "S_ptr.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Reference counted, read only range of bytes. Slices share the
+     * array of their parent and keep it alive.
+     * EXAMPLE: S_buf frame = make_buf(received, length);
+     *          S_buf payload = frame.slice(HEADER_SIZE);
+     */
+    class S_buf final
+    {
+    public:
+        /**
+         * Initializes this S_buf empty.
+         */
+        S_buf(void) = default;
+
+        /**
+         * Initializes this S_buf over bytes, which must not be modified
+         * afterwards. Does not copy anything.
+         * EXAMPLE: auto bytes = make_shared<uint8_t[]>(length);
+         *          radio_read(bytes.get(), length);
+         *          S_buf frame{ DuinoMemory::move(bytes), length };
+         * @param bytes array holding the bytes. Can be nullptr.
+         * @param size number of bytes in the array, 0 if bytes is nullptr.
+         */
+        S_buf(S_ptr<uint8_t[]> bytes, size_t size) : _bytes{ DuinoMemory::move(bytes) }, _size{ _bytes ? size : 0 }
+        {
+            // Empty body
+        }
+
+        /**
+         * @return a pointer to the first byte, nullptr if empty.
+         */
+        const uint8_t* data(void) const noexcept
+        {
+            return _bytes.get();
+        }
+
+        /**
+         * @return the number of bytes.
+         */
+        size_t size(void) const noexcept
+        {
+            return _size;
+        }
+
+        bool empty(void) const noexcept
+        {
+            return _size == 0;
+        }
+
+        explicit operator bool(void) const noexcept
+        {
+            return _size != 0;
+        }
+
+        /**
+         * @return the number of S_buf sharing the underlying array,
+         *         slices included.
+         */
+        size_t count(void) const noexcept
+        {
+            return _bytes.count();
+        }
+
+        /**
+         * @param index of the byte. Must be lower than size(); no bounds
+         *        checking is performed.
+         */
+        uint8_t operator [](size_t index) const
+        {
+            return _bytes[index];
+        }
+
+        const uint8_t* begin(void) const noexcept
+        {
+            return data();
+        }
+
+        const uint8_t* end(void) const noexcept
+        {
+            return data() + _size;
+        }
+
+        /**
+         * Creates a view over a range of this buffer, sharing its array.
+         * Constant time, no allocation. The range is clamped to the bytes
+         * available.
+         * @param offset of the first byte of the slice.
+         * @param length of the slice in bytes.
+         * @return the slice, empty if offset is past the end.
+         */
+        S_buf slice(size_t offset, size_t length) const
+        {
+            if (offset >= _size)
+            {
+                return S_buf{ };
+            }
+
+            auto available = _size - offset;
+            return S_buf{ S_ptr<uint8_t[]>{ _bytes, _bytes.get() + offset }, length < available ? length : available };
+        }
+
+        /**
+         * @param offset of the first byte of the slice.
+         * @return a view from offset to the end of this buffer.
+         */
+        S_buf slice(size_t offset) const
+        {
+            return slice(offset, _size);
+        }
+
+    private:
+        S_ptr<uint8_t[]> _bytes{ };
+        size_t _size{ };
+    };
+
+    /**
+     * Copies bytes into a new S_buf. This is the only copy: slices and
+     * copies of the result share it.
+     * @param data bytes to copy. Can be nullptr if size is 0.
+     * @param size number of bytes.
+     * @return the new S_buf, empty if size is 0 or allocation failed.
+     */
+    inline S_buf make_buf(const void* data, size_t size)
+    {
+        if (size == 0)
+        {
+            return S_buf{ };
+        }
+
+        auto bytes = make_shared<uint8_t[]>(size);
+        if (bytes)
+        {
+            memcpy(bytes.get(), data, size);
+        }
+        return S_buf{ DuinoMemory::move(bytes), size };
+    }
+
+    /**
+     * Ordered sequence of up to N S_buf, presented as a single message.
+     * Segments are written one after the other; they are never copied
+     * into a contiguous buffer.
+     * EXAMPLE: BufChain<3> message;
+     *          message.append(payload);
+     *          message.prepend(header);
+     *          message.write_to(Serial);
+     * @param N maximum number of segments.
+     */
+    template<size_t N>
+    class BufChain final
+    {
+        static_assert(N > 0, "BufChain must hold at least one segment");
+
+    public:
+        /**
+         * Initializes this BufChain without any segment.
+         */
+        BufChain(void) = default;
+
+        /**
+         * Adds segment at the end. Empty segments are ignored.
+         * @return false if the chain is full.
+         */
+        bool append(const S_buf& segment)
+        {
+            if (segment.empty())
+            {
+                return true;
+            }
+
+            if (_length == N)
+            {
+                return false;
+            }
+
+            _segments[_length++] = segment;
+            return true;
+        }
+
+        /**
+         * Adds segment at the beginning, e.g. a protocol header. Empty
+         * segments are ignored.
+         * @return false if the chain is full.
+         */
+        bool prepend(const S_buf& segment)
+        {
+            if (segment.empty())
+            {
+                return true;
+            }
+
+            if (_length == N)
+            {
+                return false;
+            }
+
+            for (auto i = _length; i > 0; i--)
+            {
+                _segments[i] = DuinoMemory::move(_segments[i - 1]);
+            }
+            _segments[0] = segment;
+            _length++;
+            return true;
+        }
+
+        /**
+         * Removes all segments, releasing their buffers.
+         */
+        void clear(void)
+        {
+            for (size_t i = 0; i < _length; i++)
+            {
+                _segments[i] = S_buf{ };
+            }
+            _length = 0;
+        }
+
+        /**
+         * @return the number of segments.
+         */
+        size_t segments(void) const noexcept
+        {
+            return _length;
+        }
+
+        /**
+         * @param index of the segment. Must be lower than segments().
+         */
+        const S_buf& operator [](size_t index) const
+        {
+            return _segments[index];
+        }
+
+        /**
+         * @return the total number of bytes of all segments.
+         */
+        size_t size(void) const
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < _length; i++)
+            {
+                total += _segments[i].size();
+            }
+            return total;
+        }
+
+        /**
+         * Writes each segment in turn, stopping at the first short write.
+         * @param writer object providing write(const uint8_t*, size_t) and
+         *        returning the number of bytes written, such as any Arduino
+         *        Print (Serial, network clients, files...).
+         * @return the number of bytes written.
+         */
+        template<typename Writer>
+        size_t write_to(Writer& writer) const
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < _length; i++)
+            {
+                auto written = writer.write(_segments[i].data(), _segments[i].size());
+                total += written;
+                if (written != _segments[i].size())
+                {
+                    break;
+                }
+            }
+            return total;
+        }
+
+    private:
+        S_buf _segments[N];
+        size_t _length{ };
+    };
+}
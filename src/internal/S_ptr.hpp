@@ -16,29 +16,71 @@
  *    Lightweight shared pointer similar to the STL std::shared_ptr.
  *    Uses a control block and reference count to manage memory deallocation.
  *    When the reference count reaches zero, the object gets destroyed.
+ *    make_shared allocates the object and its control block at once.
  *
  ******************************************************************************
  */
 #pragma once
 #include "SmartPointer.hpp"
+#include "ControlBlock.hpp"
 #include <stddef.h>
-#include <Arduino.h>
 
 namespace DuinoMemory
 {
+    template<typename T, typename Count, typename Lock>
+    class W_ptr;
+
+    template<typename T, typename Count = typename SharedTraits<T>::count_type, typename Lock = typename SharedTraits<T>::lock_type>
+    class Enable_shared_from_this;
+
+    /**
+     * Gives object the control block of its first owner, if it derives from
+     * Enable_shared_from_this. Called by the factories.
+     * @param object can be nullptr.
+     */
+    template<typename Count, typename Lock, typename X, typename C, typename L>
+    void link_shared_from_this(ControlBlock<Count, Lock>* control, const Enable_shared_from_this<X, C, L>* object);
+
+    template<typename Count, typename Lock>
+    void link_shared_from_this(ControlBlock<Count, Lock>*, const volatile void*)
+    {
+        // Not an Enable_shared_from_this.
+    }
+
     /**
      * Pointer wrapper that automatically deallocates memory when
      * reference count to the pointed object drops to 0. This means
      * that several client objects can point to the same data.
-     * @param T can be any type. CAUTION: If T is a polymorphic type,
-     *          it must have a virtual destructor, otherwise deleting
-     *          the object may lead to undefined behavior and may cause
-     *          memory leaks or crashes.
+     * @param T can be any type, or an array such as int[] (destroyed with
+     *          delete[], elements accessed with operator []). The control
+     *          block records the concrete type of the object it was created
+     *          with, so that T does not need a virtual destructor, as long
+     *          as the object is created by make_shared<T, U> or adopted as
+     *          a U*.
      */
-    template<typename T>
+    template<typename T, typename Count = typename SharedTraits<T>::count_type, typename Lock = typename SharedTraits<T>::lock_type>
     class S_ptr final : public SmartPointer<T>
     {
+        friend struct SharedFactory;
+        friend class W_ptr<T, Count, Lock>;
+        friend class Enable_shared_from_this<T, Count, Lock>;
+        friend class CycleCollector<Count, Lock>;
+
+        template<typename, typename, typename>
+        friend class S_ptr;
+
+        // Enables an overload only if U* converts to T*.
+        template<typename U>
+        using if_compatible = typename enable_if<is_convertible<U*, T*>::value>::type;
+
+        // Enables adoption of a U*: derived types, or any pointer to an
+        // array element so that mismatches are reported by a static_assert.
+        template<typename U>
+        using if_adoptable = typename enable_if<is_convertible<U*, T*>::value || is_array<T>::value>::type;
+
     public:
+        using element_type = typename SmartPointer<T>::element_type;
+
         /**
          * Initializes this S_ptr as nullptr.
          */
@@ -46,48 +88,117 @@ namespace DuinoMemory
 
         /**
          * Initializes this S_ptr with the provided pointer to data. If data not null,
-         * increases the reference count to 1.
-         * CAUTION:S_ptr performs two dynamic allocations (object + reference counter).
+         * allocates a control block with a reference count of 1.
+         * CAUTION: Adopting a raw pointer performs two dynamic allocations (object +
+         * control block). Prefer make_shared, which only performs one.
          * On small-memory boards (e.g. AVR), excessive creation/destruction of S_ptr
          * may lead to heap fragmentation.
          * Prefer static allocation or long-lived shared objects.
          * @param data pointer. Can be nullptr.
          */
-        explicit S_ptr(T* data) : SmartPointer<T>{ data }
+        explicit S_ptr(element_type* data) : SmartPointer<T>{ data }
+        {
+            adopt<T>(data);
+        }
+
+        /**
+         * Initializes this S_ptr with a pointer to a derived type. The control
+         * block remembers U, so the object is deleted as a U even if T has no
+         * virtual destructor.
+         * @param U type derived from T.
+         * @param data pointer. Can be nullptr.
+         */
+        template<typename U, typename = if_adoptable<U>>
+        explicit S_ptr(U* data) : SmartPointer<T>{ data }
         {
-            if (data != nullptr)
+            adopt<U>(data);
+        }
+
+        S_ptr(const S_ptr<T, Count, Lock>& other) : SmartPointer<T>{ other.get() }, _control{ other._control }
+        {
+            if (_control != nullptr)
             {
-                _ref_count = new size_t{ 1 };
+                _control->acquire();
+            }
+        }
 
-                if (_ref_count == nullptr)
-                {
-                    delete data;
-                    SmartPointer<T>::set_data(nullptr);
-                }
+        /**
+         * Takes over the reference held by other, leaving it null.
+         * The reference count is not modified.
+         */
+        S_ptr(S_ptr<T, Count, Lock>&& other) noexcept : SmartPointer<T>{ other.get() }, _control{ other._control }
+        {
+            other.set_data(nullptr);
+            other._control = nullptr;
+        }
+
+        /**
+         * Shares ownership with other, a S_ptr to a derived type. Both use
+         * the same control block.
+         * @param U type whose pointers convert to T*.
+         */
+        template<typename U, typename = if_compatible<U>>
+        S_ptr(const S_ptr<U, Count, Lock>& other) : SmartPointer<T>{ other.get() }, _control{ other._control }
+        {
+            if (_control != nullptr)
+            {
+                _control->acquire();
             }
         }
 
-        S_ptr(const S_ptr<T>& other) : SmartPointer<T>{ other.get() }, _ref_count{ other._ref_count }
+        /**
+         * Takes over the reference held by other, a S_ptr to a derived
+         * type, leaving it null. The reference count is not modified.
+         * @param U type whose pointers convert to T*.
+         */
+        template<typename U, typename = if_compatible<U>>
+        S_ptr(S_ptr<U, Count, Lock>&& other) noexcept : SmartPointer<T>{ other.get() }, _control{ other._control }
+        {
+            other.set_data(nullptr);
+            other._control = nullptr;
+        }
+
+        /**
+         * Aliasing constructor: shares ownership of owner's object, but
+         * points to data, typically one of its members. data stays valid
+         * as long as this S_ptr exists.
+         * EXAMPLE: S_ptr<Buffer> payload{ packet, &packet->payload };
+         * @param owner S_ptr whose reference count is shared. Can be null,
+         *        in which case nothing is owned.
+         * @param data pointer returned by get(). Not managed by this S_ptr.
+         */
+        template<typename U>
+        S_ptr(const S_ptr<U, Count, Lock>& owner, element_type* data) : SmartPointer<T>{ data }, _control{ owner._control }
         {
-            if (other.get() != nullptr && _ref_count != nullptr)
+            if (_control != nullptr)
             {
-                noInterrupts();
-                (*_ref_count)++;
-                interrupts();
+                _control->acquire();
             }
         }
 
+        /**
+         * Aliasing constructor taking over the reference held by owner,
+         * leaving it null. The reference count is not modified.
+         */
+        template<typename U>
+        S_ptr(S_ptr<U, Count, Lock>&& owner, element_type* data) noexcept : SmartPointer<T>{ data }, _control{ owner._control }
+        {
+            owner.set_data(nullptr);
+            owner._control = nullptr;
+        }
+
         ~S_ptr(void)
         {
             release();
         }
 
         /**
-         * @return the number of active references to this S_ptr.
+         * @return the number of active references to this S_ptr. Saturated
+         *         counts return the maximum value of Count.
          */
         size_t count(void) const noexcept
         {
-            return _ref_count != nullptr ? *_ref_count : 0;
+            return _control != nullptr ? _control->count() : 0;
         }
 
         /**
@@ -97,78 +208,262 @@ namespace DuinoMemory
          *          ptr = other;                        ==> SAFE, very common use case.
          *          ptr = some_object->build_object();  ==> SAFE, common use case.
          */
-        S_ptr<T>& operator =(T* data_ptr)
+        S_ptr<T, Count, Lock>& operator =(element_type* data_ptr)
         {
             if (data_ptr != SmartPointer<T>::get())
             {
                 release();
                 SmartPointer<T>::set_data(data_ptr);
-                _ref_count = data_ptr != nullptr ? new size_t{ 1 } : nullptr;
+                adopt<T>(data_ptr);
+            }
+            return *this;
+        }
 
-                if (_ref_count == nullptr)
-                {
-                    delete data_ptr;
-                    SmartPointer<T>::set_data(nullptr);
-                }
+        /**
+         * Same as above, deleting the object as a U once the count drops to 0.
+         * @param U type derived from T.
+         */
+        template<typename U, typename = if_adoptable<U>>
+        S_ptr<T, Count, Lock>& operator =(U* data_ptr)
+        {
+            if (data_ptr != SmartPointer<T>::get())
+            {
+                release();
+                SmartPointer<T>::set_data(data_ptr);
+                adopt<U>(data_ptr);
             }
             return *this;
         }
 
-        S_ptr<T>& operator =(const S_ptr<T>& other)
+        S_ptr<T, Count, Lock>& operator =(const S_ptr<T, Count, Lock>& other)
         {
             if (this != &other)
             {
                 release();
-                auto other_data = other.get();
-                SmartPointer<T>::set_data(other_data);
-                _ref_count = other._ref_count;
-                if (other_data != nullptr && _ref_count != nullptr)
+                SmartPointer<T>::set_data(other.get());
+                _control = other._control;
+                if (_control != nullptr)
                 {
-                    noInterrupts();
-                    (*_ref_count)++;
-                    interrupts();
+                    _control->acquire();
                 }
             }
             return *this;
         }
 
+        /**
+         * Releases the current reference and takes over the one held by
+         * other, leaving it null. other's reference count is not modified.
+         */
+        S_ptr<T, Count, Lock>& operator =(S_ptr<T, Count, Lock>&& other) noexcept
+        {
+            // Avoid self assignment.
+            if (this != &other)
+            {
+                release();
+                SmartPointer<T>::set_data(other.get());
+                _control = other._control;
+                other.set_data(nullptr);
+                other._control = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Releases the current reference and shares ownership with other,
+         * a S_ptr to a derived type.
+         * @param U type whose pointers convert to T*.
+         */
+        template<typename U, typename = if_compatible<U>>
+        S_ptr<T, Count, Lock>& operator =(const S_ptr<U, Count, Lock>& other)
+        {
+            // Hold the new reference first, in case other is owned by the
+            // current object.
+            S_ptr<T, Count, Lock> copy{ other };
+            return *this = DuinoMemory::move(copy);
+        }
+
+        /**
+         * Releases the current reference and takes over the one held by
+         * other, a S_ptr to a derived type, leaving it null.
+         * @param U type whose pointers convert to T*.
+         */
+        template<typename U, typename = if_compatible<U>>
+        S_ptr<T, Count, Lock>& operator =(S_ptr<U, Count, Lock>&& other) noexcept
+        {
+            // Detach other first, in case it is owned by the current object.
+            S_ptr<T, Count, Lock> taken{ DuinoMemory::move(other) };
+            return *this = DuinoMemory::move(taken);
+        }
+
     private:
-        size_t* _ref_count{ };
+        ControlBlock<Count, Lock>* _control{ };
 
-        void release(void)
+        /**
+         * Takes over an already referenced control block, without
+         * modifying its count. Reserved to factories.
+         */
+        S_ptr(element_type* data, ControlBlock<Count, Lock>* control) : SmartPointer<T>{ data }, _control{ control }
         {
-            if (_ref_count == nullptr)
+            // Empty body
+        }
+
+        // The block deletes data as a U (with delete[] for arrays),
+        // whatever T is.
+        template<typename U>
+        void adopt(typename remove_extent<U>::type* data)
+        {
+            static_assert(!is_array<T>::value || is_array<U>::value, "Arrays must be adopted through a pointer to their exact element type");
+
+            _control = data != nullptr ? heap_new<AdoptedBlock<U, Count, Lock>>(data, static_cast<bool>(SharedTraits<T>::deferred)) : nullptr;
+
+            if (_control == nullptr)
             {
+                DefaultDelete<U>{ }(data);
                 SmartPointer<T>::set_data(nullptr);
-                return;
             }
+            else if (!is_array<U>::value)
+            {
+                link_shared_from_this(_control, data);
+                link_cycle_collector(_control, data);
+            }
+        }
 
-            auto data = SmartPointer<T>::get();
-            if (data != nullptr)
-            {    
-                noInterrupts();            
-                (*_ref_count)--;
-                
-                if (*_ref_count == 0)
-                {
-                    delete data;
-                    delete _ref_count;
-                }
-                interrupts();
+        void release(void)
+        {
+            if (_control != nullptr)
+            {
+                _control->release();
             }
 
             SmartPointer<T>::set_data(nullptr);
-            _ref_count = nullptr;
+            _control = nullptr;
         }
     };
 
+    /**
+     * Builds S_ptr instances from control blocks. Used by the factories;
+     * client code should call make_shared instead.
+     */
+    struct SharedFactory
+    {
+        /**
+         * Wraps an object whose control block was just created by the
+         * caller, and links it to its block if it derives from
+         * Enable_shared_from_this or if the block is Collected.
+         * @param data pointer to the managed object, as its concrete type.
+         *        Cannot be nullptr.
+         * @param control block with a count of 1, in charge of destroying data.
+         * @return a S_ptr<T, Count, Lock> taking over the reference held by control.
+         */
+        template<typename T, typename Count, typename Lock, typename U>
+        static S_ptr<T, Count, Lock> from_block(U* data, ControlBlock<Count, Lock>* control)
+        {
+            link_shared_from_this(control, is_array<T>::value ? nullptr : data);
+            link_cycle_collector(control, is_array<T>::value ? nullptr : data);
+            return S_ptr<T, Count, Lock>{ data, control };
+        }
+
+        /**
+         * Allocates the object and its reference count in a single block.
+         * @param T type of the resulting S_ptr.
+         * @param U type of the object to construct. Must be T or derive from T.
+         * @param args must match one of U's constructors.
+         * @return a S_ptr<T> pointing to the new object, or nullptr if
+         *         allocation failed.
+         */
+        template<typename T, typename U, class... Args>
+        static S_ptr<T> make_inplace(Args&&... args)
+        {
+            using Traits = SharedTraits<T>;
+            auto block = heap_new<InplaceBlock<U, typename Traits::count_type, typename Traits::lock_type>>(static_cast<bool>(Traits::deferred));
+            if (block == nullptr)
+            {
+                return S_ptr<T>{ };
+            }
+
+            return from_block<T, typename Traits::count_type, typename Traits::lock_type>(block->construct(DuinoMemory::forward<Args>(args)...), block);
+        }
+    };
+
+    /**
+     * Base class of objects handing out S_ptr to themselves, e.g. to
+     * register in a callback from a member function. The factories and
+     * the S_ptr adopting the object fill in a back-reference to its control
+     * block, so that shared_from_this() adds to the existing count instead
+     * of creating a second one.
+     * EXAMPLE: class Driver : public Enable_shared_from_this<Driver>
+     *          {
+     *              void start(void) { bus.on_done(shared_from_this()); }
+     *          };
+     * The back-reference does not count as a reference: it is only used
+     * while the object is alive, and the block outlives the object.
+     * @param T class deriving from Enable_shared_from_this<T>.
+     * @param Count must match the S_ptr owning the object.
+     * @param Lock must match the S_ptr owning the object.
+     */
+    template<typename T, typename Count, typename Lock>
+    class Enable_shared_from_this
+    {
+        template<typename C, typename L, typename X, typename C2, typename L2>
+        friend void link_shared_from_this(ControlBlock<C, L>* control, const Enable_shared_from_this<X, C2, L2>* object);
+
+    public:
+        /**
+         * @return a S_ptr sharing ownership of this object with its other
+         *         owners, or nullptr if it is not owned by any S_ptr (e.g.
+         *         from its constructor, from its destructor, or for an
+         *         object on the stack).
+         */
+        S_ptr<T, Count, Lock> shared_from_this(void)
+        {
+            if (_control != nullptr && _control->try_acquire())
+            {
+                return S_ptr<T, Count, Lock>{ static_cast<T*>(this), _control };
+            }
+            return S_ptr<T, Count, Lock>{ };
+        }
+
+    protected:
+        Enable_shared_from_this(void) = default;
+
+        // A copy is a new object: it is not owned by the S_ptr of the
+        // original.
+        Enable_shared_from_this(const Enable_shared_from_this<T, Count, Lock>&) noexcept
+        {
+            // Empty body
+        }
+
+        Enable_shared_from_this<T, Count, Lock>& operator =(const Enable_shared_from_this<T, Count, Lock>&) noexcept
+        {
+            return *this;
+        }
+
+        ~Enable_shared_from_this(void) = default;
+
+    private:
+        ControlBlock<Count, Lock>* _control{ };
+    };
+
+    template<typename Count, typename Lock, typename X, typename C, typename L>
+    void link_shared_from_this(ControlBlock<Count, Lock>* control, const Enable_shared_from_this<X, C, L>* object)
+    {
+        static_assert(is_same<Count, C>::value && is_same<Lock, L>::value,
+            "Enable_shared_from_this count and lock types must match the S_ptr owning the object");
+
+        // Only the first owner counts: adopting the object twice is a bug.
+        if (object != nullptr && object->_control == nullptr)
+        {
+            const_cast<Enable_shared_from_this<X, C, L>*>(object)->_control = control;
+        }
+    }
+
     /**
      * @return a S_ptr pointing to a default instance of T.
      */
     template<typename T>
-    S_ptr<T> make_shared(void)
+    typename enable_if<!is_array<T>::value, S_ptr<T>>::type make_shared(void)
     {
-        return S_ptr<T>{ new T{ } };
+        return SharedFactory::make_inplace<T, T>();
     }
 
     /**
@@ -178,32 +473,55 @@ namespace DuinoMemory
      * @return a S_ptr instance pointing to the newly created instance of T.
      */
     template<typename T, class... Args>
-    S_ptr<T> make_shared(Args&&... args)
+    typename enable_if<!is_array<T>::value, S_ptr<T>>::type make_shared(Args&&... args)
     {
-        return S_ptr<T>{ new T(args...) };
+        return SharedFactory::make_inplace<T, T>(DuinoMemory::forward<Args>(args)...);
+    }
+
+    /**
+     * Creates an array of size value initialized elements (zeros for
+     * arithmetic types), shared by S_ptr. The elements and the reference
+     * count are allocated in a single block.
+     * EXAMPLE: S_ptr<uint8_t[]> frame = make_shared<uint8_t[]>(32);
+     * @param T array type, such as uint8_t[].
+     * @param size number of elements.
+     * @return a new S_ptr<T> owning the array, or nullptr if allocation
+     *         failed.
+     */
+    template<typename T>
+    typename enable_if<is_array<T>::value, S_ptr<T>>::type make_shared(size_t size)
+    {
+        using Traits = SharedTraits<T>;
+        using Block = ArrayBlock<typename remove_extent<T>::type, typename Traits::count_type, typename Traits::lock_type>;
+
+        auto block = Block::create(size, Traits::deferred);
+        if (block == nullptr)
+        {
+            return S_ptr<T>{ };
+        }
+
+        return SharedFactory::from_block<T, typename Traits::count_type, typename Traits::lock_type>(block->elements(), block);
     }
 
     /**
      * Creates a new instance of S_ptr<t> holding a default initialized
      * instance of U.
-     * @param T can be any type. CAUTION: as a base type, T must have a virtual
-     *        destructor, otherwise deleting the base pointer may lead to
-     *        undefined behavior and cause memory leaks or crashes.
+     * @param T can be any type. It does not need a virtual destructor: the
+     *        control block destroys the object as a U.
      * @param U is a derived type of T.
      * @return a new S_ptr<T> wrapping the newly instanced U.
      */
     template<typename T, typename U>
     S_ptr<T> make_shared(void)
     {
-        return S_ptr<T>{ new U{ } };
+        return SharedFactory::make_inplace<T, U>();
     }
 
     /**
      * Creates a new instance of S_ptr<t> holding a instance of U initialized
      * with given parameters.
-     * @param T can be any type. CAUTION: as a base type, T must have a virtual
-     *        destructor, otherwise deleting the base pointer may lead to
-     *        undefined behavior and cause memory leaks or crashes.
+     * @param T can be any type. It does not need a virtual destructor: the
+     *        control block destroys the object as a U.
      * @param U is a derived type of T.
      * @param Args types of arguments.
      * @param args must match one of U's parameterized constructors.
@@ -212,6 +530,6 @@ namespace DuinoMemory
     template<typename T, typename U, class... Args>
     S_ptr<T> make_shared(Args&&... args)
     {
-        return S_ptr<T>{ new U(args...) };
+        return SharedFactory::make_inplace<T, U>(DuinoMemory::forward<Args>(args)...);
     }
 }
\ No newline at end of file
@@ -0,0 +1,364 @@
+/*
+ ******************************************************************************
+ *  SlotMap.hpp
+ *
+ *  Densely stored objects addressed by generational handles.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    SlotMap keeps up to N objects contiguous in a statically sized array,
+ *    so that iterating over them walks memory linearly. Objects are moved
+ *    when others are erased, so they are referred to by handles instead of
+ *    pointers: a 16 or 32 bit value made of a slot index, giving the
+ *    current position of the object, and of the generation of that slot,
+ *    bumped at each erase. A handle to an erased object is therefore
+ *    detected instead of reaching another object. Insert, erase and lookup
+ *    take constant time and never touch the heap.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "Utility.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <new.h>
+#else
+#include <new>
+#endif
+
+namespace DuinoMemory
+{
+    /**
+     * @return the number of bits needed to write value, 0 for 0.
+     */
+    constexpr uint8_t bit_width(size_t value)
+    {
+        return value == 0 ? 0 : 1 + bit_width(value / 2);
+    }
+
+    /**
+     * Capacity independent part of SlotMap: handle checking, insertion and
+     * erasure over storage provided by the derived class.
+     * @param T type of the stored objects. Must be move constructible.
+     * @param Handle unsigned integer type of the handles, e.g. uint16_t.
+     */
+    template<typename T, typename Handle>
+    class SlotMapBase
+    {
+        static_assert(static_cast<Handle>(-1) > static_cast<Handle>(0), "Handle must be an unsigned integer type");
+
+    public:
+        using handle_type = Handle;
+
+        /**
+         * Handle value never given to an object.
+         */
+        static constexpr Handle NONE = 0;
+
+        SlotMapBase(const SlotMapBase<T, Handle>& other) = delete;
+        SlotMapBase<T, Handle>& operator =(const SlotMapBase<T, Handle>& other) = delete;
+
+        /**
+         * Constructs an object at the end of the dense storage.
+         * @param args must match one of T's constructors.
+         * @return the handle of the new object, or NONE if the map is full.
+         */
+        template<class... Args>
+        Handle insert(Args&&... args)
+        {
+            auto slot = take();
+            if (slot == FULL)
+            {
+                return NONE;
+            }
+
+            ::new (static_cast<void*>(_objects + _size)) T(DuinoMemory::forward<Args>(args)...);
+            return place(slot);
+        }
+
+        /**
+         * Value initializes an object at the end of the dense storage.
+         * @return the handle of the new object, or NONE if the map is full.
+         */
+        Handle insert(void)
+        {
+            auto slot = take();
+            if (slot == FULL)
+            {
+                return NONE;
+            }
+
+            ::new (static_cast<void*>(_objects + _size)) T{ };
+            return place(slot);
+        }
+
+        /**
+         * Destroys an object. The last object is moved into its place, so
+         * that storage stays dense: pointers to it become invalid, while
+         * its handle remains valid.
+         * @param handle can be stale or NONE.
+         * @return false if handle did not refer to an object.
+         */
+        bool erase(Handle handle)
+        {
+            auto slot = find(handle);
+            if (slot == FULL)
+            {
+                return false;
+            }
+
+            auto position = _slots[slot].position;
+            auto last = static_cast<Handle>(_size - 1);
+            _objects[position].~T();
+            if (position != last)
+            {
+                ::new (static_cast<void*>(_objects + position)) T(DuinoMemory::move(_objects[last]));
+                _objects[last].~T();
+                _owners[position] = _owners[last];
+                _slots[_owners[position]].position = position;
+            }
+            _size--;
+
+            // Generation 0 is never used, so that NONE never matches.
+            auto generation = static_cast<Handle>((_slots[slot].generation + 1) & (static_cast<Handle>(-1) >> _index_bits));
+            _slots[slot].generation = generation != 0 ? generation : 1;
+            _slots[slot].position = _free;
+            _free = slot;
+            return true;
+        }
+
+        /**
+         * Destroys every object. Outstanding handles become stale.
+         */
+        void clear(void)
+        {
+            while (_size > 0)
+            {
+                erase(handle_at(_size - 1));
+            }
+        }
+
+        /**
+         * Checks handle in constant time.
+         * @param handle can be stale or NONE.
+         * @return the object, or nullptr if it was erased. Valid until the
+         *         next erase.
+         */
+        T* get(Handle handle) noexcept
+        {
+            auto slot = find(handle);
+            return slot != FULL ? _objects + _slots[slot].position : nullptr;
+        }
+
+        const T* get(Handle handle) const noexcept
+        {
+            auto slot = find(handle);
+            return slot != FULL ? _objects + _slots[slot].position : nullptr;
+        }
+
+        /**
+         * @return true if handle refers to an object.
+         */
+        bool contains(Handle handle) const noexcept
+        {
+            return find(handle) != FULL;
+        }
+
+        /**
+         * @param position of an object in the dense storage, lower than
+         *        size().
+         * @return the handle of that object.
+         */
+        Handle handle_at(size_t position) const noexcept
+        {
+            auto slot = _owners[position];
+            return static_cast<Handle>((static_cast<Handle>(_slots[slot].generation) << _index_bits) | slot);
+        }
+
+        /**
+         * Dense storage, in no particular order: erase() moves the last
+         * object.
+         * EXAMPLE: for (auto& sprite : sprites) { sprite.draw(); }
+         */
+        T* begin(void) noexcept
+        {
+            return _objects;
+        }
+
+        T* end(void) noexcept
+        {
+            return _objects + _size;
+        }
+
+        const T* begin(void) const noexcept
+        {
+            return _objects;
+        }
+
+        const T* end(void) const noexcept
+        {
+            return _objects + _size;
+        }
+
+        /**
+         * @return the number of objects.
+         */
+        size_t size(void) const noexcept
+        {
+            return _size;
+        }
+
+        bool empty(void) const noexcept
+        {
+            return _size == 0;
+        }
+
+    protected:
+        /**
+         * Slot of a handle: where its object is, and which generation of
+         * handles may reach it. Free slots chain through position.
+         */
+        struct Slot
+        {
+            Handle generation;
+            Handle position;
+        };
+
+        /**
+         * Initializes this SlotMapBase empty, over storage owned by the
+         * derived class. Slots are initialized on first use.
+         * @param objects room for capacity objects.
+         * @param slots capacity slots.
+         * @param owners capacity slot indices, one per object position.
+         * @param index_bits low bits of a handle holding the slot index.
+         */
+        SlotMapBase(T* objects, Slot* slots, Handle* owners, size_t capacity, uint8_t index_bits) noexcept
+            : _objects{ objects }, _slots{ slots }, _owners{ owners }, _capacity{ capacity }, _index_bits{ index_bits }
+        {
+            // Empty body
+        }
+
+        ~SlotMapBase(void) = default;
+
+    private:
+        // No slot: end of the free list, or failed lookup.
+        static constexpr Handle FULL = static_cast<Handle>(-1);
+
+        T* _objects;
+        Slot* _slots;
+        Handle* _owners;        // Slot of the object at each position.
+        size_t _capacity;
+        size_t _size{ };
+        size_t _untouched{ };   // Slots never used so far.
+        Handle _free{ FULL };
+        uint8_t _index_bits;
+
+        Handle take(void)
+        {
+            auto slot = _free;
+            if (slot != FULL)
+            {
+                _free = _slots[slot].position;
+            }
+            else if (_untouched < _capacity)
+            {
+                slot = static_cast<Handle>(_untouched++);
+                _slots[slot].generation = 1;
+            }
+            return slot;
+        }
+
+        Handle place(Handle slot)
+        {
+            _slots[slot].position = static_cast<Handle>(_size);
+            _owners[_size] = slot;
+            _size++;
+            return handle_at(_size - 1);
+        }
+
+        Handle find(Handle handle) const noexcept
+        {
+            auto slot = static_cast<Handle>(handle & ((static_cast<Handle>(1) << _index_bits) - 1));
+            if (handle == NONE || slot >= _untouched)
+            {
+                return FULL;
+            }
+
+            // A freed slot has a newer generation than its old handles.
+            auto& entry = _slots[slot];
+            if (entry.generation != static_cast<Handle>(handle >> _index_bits)
+                || entry.position >= _size || _owners[entry.position] != slot)
+            {
+                return FULL;
+            }
+            return slot;
+        }
+    };
+
+    /**
+     * Up to N objects of type T, stored contiguously and addressed by
+     * generational handles. Declare it as a global or static variable so
+     * that its storage is reserved at link time.
+     * EXAMPLE: SlotMap<Sprite, 32> sprites;
+     *          auto ship = sprites.insert(0, 0);
+     *          H_ptr<Sprite> view{ sprites, ship };
+     *          sprites.erase(ship);        // view is now null.
+     * Each slot's generation wraps after 2^(bits of Handle - bits of N) - 1
+     * erasures, after which a very old handle could match again.
+     * CAUTION: not safe to use from ISRs.
+     * @param T type of the stored objects. Must be move constructible.
+     * @param N capacity.
+     * @param Handle uint16_t or uint32_t, with room for N and a few bits
+     *        of generation.
+     */
+    template<typename T, size_t N, typename Handle = uint16_t>
+    class SlotMap final : public SlotMapBase<T, Handle>
+    {
+        static constexpr uint8_t INDEX_BITS = N > 1 ? bit_width(N - 1) : 1;
+
+        static_assert(N > 0, "SlotMap must have at least one slot");
+        static_assert(INDEX_BITS + 4 <= sizeof(Handle) * 8, "SlotMap handle too small for N: use a wider Handle, e.g. uint32_t");
+
+        using Base = SlotMapBase<T, Handle>;
+
+    public:
+        /**
+         * Initializes this SlotMap empty. Does not touch the storage.
+         */
+        SlotMap(void) noexcept
+            : Base{ reinterpret_cast<T*>(_storage), _slots, _owners, N, INDEX_BITS }
+        {
+            // Empty body
+        }
+
+        /**
+         * Destroys the remaining objects.
+         */
+        ~SlotMap(void)
+        {
+            Base::clear();
+        }
+
+        /**
+         * @return the maximum number of objects.
+         */
+        constexpr size_t capacity(void) const noexcept
+        {
+            return N;
+        }
+
+    private:
+        alignas(T) unsigned char _storage[N * sizeof(T)];
+        typename Base::Slot _slots[N];
+        Handle _owners[N];
+    };
+}
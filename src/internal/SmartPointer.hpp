@@ -20,6 +20,8 @@
  ******************************************************************************
  */
 #pragma once
+#include "Utility.hpp"
+#include <stddef.h>
 
 namespace DuinoMemory
 {
@@ -27,12 +29,16 @@ namespace DuinoMemory
      * Base behavior for all smart pointers for Arduino. Smart pointers
      * manage memory deallocation automatically and greatly reduce risks
      * of memory leaks.
-     * @param T can be any type. CAUTION: arrays are not supported.
+     * @param T can be any type, or an array of unknown bound such as int[].
+     *        Arrays of known bound (int[4]) are not supported.
      */
     template<typename T>
     class SmartPointer
     {
     public:
+        // Type of the pointed objects: T, or the element type of an array.
+        using element_type = typename remove_extent<T>::type;
+
         // Don't manage deallocation here, derived types shall do it.
         // _data is not destroyed in base class. Concrete types must ensure
         // proper memory deallocation according to their needs.
@@ -41,7 +47,7 @@ namespace DuinoMemory
         /**
          * @return _data member as a non mutable pointer.
          */
-        T* get(void) const
+        element_type* get(void) const
         {
             return _data;
         }
@@ -52,8 +58,28 @@ namespace DuinoMemory
          *   Always check that the pointer is valid before dereferencing:
          *       if (ptr) { ptr->method(); }
          */
-        T& operator *(void) const { return *_data; }
-        T* operator ->(void) const { return _data; }
+        element_type& operator *(void) const
+        {
+            static_assert(!is_array<T>::value, "Use operator [] to access array elements");
+            return *_data;
+        }
+
+        element_type* operator ->(void) const
+        {
+            static_assert(!is_array<T>::value, "Use operator [] to access array elements");
+            return _data;
+        }
+
+        /**
+         * Accesses an element of a pointed array. Only available when T
+         * is an array type. No bounds checking is performed.
+         * @param index of the element. Must be lower than the array size.
+         */
+        element_type& operator [](size_t index) const
+        {
+            static_assert(is_array<T>::value, "operator [] requires an array type, e.g. U_ptr<int[]>");
+            return _data[index];
+        }
 
         explicit operator bool(void) const
         {
@@ -70,22 +96,22 @@ namespace DuinoMemory
             return a.get() != b.get();
         }
 
-        friend bool operator ==(const SmartPointer<T>& sp, const T* p)
+        friend bool operator ==(const SmartPointer<T>& sp, const element_type* p)
         {
             return sp.get() == p;
         }
 
-        friend bool operator ==(const T* p, const SmartPointer<T>& sp)
+        friend bool operator ==(const element_type* p, const SmartPointer<T>& sp)
         {
             return sp.get() == p;
         }
 
-        friend bool operator !=(const SmartPointer<T>& sp, const T* p)
+        friend bool operator !=(const SmartPointer<T>& sp, const element_type* p)
         {
             return sp.get() != p;
         }
 
-        friend bool operator !=(T* p, const SmartPointer<T>& sp)
+        friend bool operator !=(element_type* p, const SmartPointer<T>& sp)
         {
             return sp != p;
         }
@@ -101,7 +127,7 @@ namespace DuinoMemory
          * pointer.
          * @param data can be nullptr.
          */
-        explicit SmartPointer(T* data) : _data{ data }
+        explicit SmartPointer(element_type* data) : _data{ data }
         {
             // Empty body
         }
@@ -113,9 +139,9 @@ namespace DuinoMemory
          *          memory leak otherwise.
          * @param new_data to assign. Can be nullptr.
          */
-        void set_data(T* new_data) { _data = new_data; }
+        void set_data(element_type* new_data) { _data = new_data; }
 
     private:
-        T* _data{ };
+        element_type* _data{ };
     };
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+/*
+ ******************************************************************************
+ *  SpscQueue.hpp
+ *
+ *  Lock-free single producer, single consumer queue of U_ptr.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    SpscQueue hands the ownership of objects from one context to another,
+ *    typically from an ISR to loop(), without masking interrupts. Only
+ *    pointers travel through the queue: objects are never copied. Pushing
+ *    and popping never allocate, so that an ISR can push objects it got
+ *    from another SpscQueue, refilled by loop() from an ObjectPool.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "U_ptr.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Fixed capacity ring of owned objects, safe without any lock as long
+     * as exactly one context pushes and exactly one context pops.
+     * EXAMPLE: SpscQueue<Frame, 4> ready;
+     *          // ISR:    ready.push(DuinoMemory::move(frame));
+     *          // loop(): auto frame = ready.pop();
+     * CAUTION: never push from two contexts, nor pop from two contexts.
+     *          Masking interrupts does not protect against other cores; on
+     *          multi-core targets, hardware atomics are used.
+     * @param T type of the queued objects.
+     * @param N capacity, from 1 to 254 so that indices fit a single byte and
+     *        are read and written atomically, even on AVR.
+     * @param Deleter stateless deleter of the queued U_ptr, e.g. PoolDelete.
+     */
+    template<typename T, size_t N, typename Deleter = DefaultDelete<T>>
+    class SpscQueue final
+    {
+        static_assert(N > 0 && N < 255, "SpscQueue capacity must be between 1 and 254");
+        static_assert(__is_empty(Deleter), "SpscQueue requires a stateless deleter, such as DefaultDelete or PoolDelete");
+
+        using element_type = typename remove_extent<T>::type;
+
+    public:
+        /**
+         * Initializes this SpscQueue empty.
+         */
+        SpscQueue(void) = default;
+
+        SpscQueue(const SpscQueue<T, N, Deleter>& other) = delete;
+        SpscQueue<T, N, Deleter>& operator =(const SpscQueue<T, N, Deleter>& other) = delete;
+
+        /**
+         * Destroys the objects still queued.
+         */
+        ~SpscQueue(void)
+        {
+            while (pop())
+            {
+                // Popped object destroyed right away.
+            }
+        }
+
+        /**
+         * Takes over item and queues it. Producer side only.
+         * Does not allocate, so it can be called from an ISR.
+         * @param item can be nullptr.
+         * @return false if the queue is full; item then keeps its object.
+         */
+        bool push(U_ptr<T, Deleter>&& item)
+        {
+            auto tail = _tail;
+            auto next = advance(tail);
+            if (next == load_acquire(_head))
+            {
+                return false;
+            }
+
+            _slots[tail] = item.detach();
+            store_release(_tail, next);
+            return true;
+        }
+
+        /**
+         * Takes the oldest queued object. Consumer side only.
+         * @return the object, or nullptr if the queue is empty.
+         */
+        U_ptr<T, Deleter> pop(void)
+        {
+            auto head = _head;
+            if (head == load_acquire(_tail))
+            {
+                return U_ptr<T, Deleter>{ };
+            }
+
+            auto data = _slots[head];
+            store_release(_head, advance(head));
+            return U_ptr<T, Deleter>{ data, typename U_ptr<T, Deleter>::Untracked{ } };
+        }
+
+        /**
+         * @return true if no object is queued. Exact from the consumer
+         *         side, may be outdated from the producer side.
+         */
+        bool empty(void) const
+        {
+            return load_acquire(_head) == load_acquire(_tail);
+        }
+
+        /**
+         * @return the number of queued objects. Only a snapshot while the
+         *         other side is running.
+         */
+        size_t size(void) const
+        {
+            auto head = load_acquire(_head);
+            auto tail = load_acquire(_tail);
+            return tail >= head ? tail - head : tail + SLOTS - head;
+        }
+
+        /**
+         * @return the maximum number of queued objects.
+         */
+        constexpr size_t capacity(void) const noexcept
+        {
+            return N;
+        }
+
+    private:
+        // One slot stays free to tell a full queue from an empty one.
+        static constexpr uint8_t SLOTS = N + 1;
+
+        element_type* _slots[SLOTS];
+        uint8_t _head{ };    // Written by the consumer only.
+        uint8_t _tail{ };    // Written by the producer only.
+
+        static uint8_t advance(uint8_t index)
+        {
+            return index + 1 < SLOTS ? index + 1 : 0;
+        }
+
+#if defined(__AVR__)
+        // Single core and single byte accesses: only the compiler must be
+        // kept from reordering memory accesses.
+        static uint8_t load_acquire(const uint8_t& index)
+        {
+            auto value = *static_cast<const volatile uint8_t*>(&index);
+            __asm__ volatile ("" : : : "memory");
+            return value;
+        }
+
+        static void store_release(uint8_t& index, uint8_t value)
+        {
+            __asm__ volatile ("" : : : "memory");
+            *static_cast<volatile uint8_t*>(&index) = value;
+        }
+#else
+        static uint8_t load_acquire(const uint8_t& index)
+        {
+            return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+        }
+
+        static void store_release(uint8_t& index, uint8_t value)
+        {
+            __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+        }
+#endif
+    };
+}
@@ -0,0 +1,392 @@
+/*
+ ******************************************************************************
+ *  Tlsf.hpp
+ *
+ *  Two-Level Segregated Fit allocator with constant time operations.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Tlsf manages a fixed region with free lists indexed by two levels:
+ *    the power of two range of the block size, then one of eight linear
+ *    subdivisions of that range. Two bitmaps locate a large enough free
+ *    block with a couple of bit scans, and freed blocks are merged with
+ *    their physical neighbors right away. allocate() and deallocate()
+ *    therefore run in bounded time whatever the state of the region,
+ *    unlike first-fit heaps walking their free list.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Header of a Tlsf block. The free list links overlap the payload, so
+     * that allocated blocks only pay for the first two fields.
+     */
+    struct TlsfBlock
+    {
+        TlsfBlock* previous;        // Physically previous block, nullptr for the first.
+        size_t size;                // Payload bytes, FREE bit set while free.
+        TlsfBlock* next_free;
+        TlsfBlock* previous_free;
+    };
+
+    /**
+     * @return the index of the highest set bit of value, 0 for 0.
+     */
+    constexpr uint8_t floor_log2(size_t value)
+    {
+        return value < 2 ? 0 : 1 + floor_log2(value / 2);
+    }
+
+    /**
+     * Size independent layout of a Tlsf region.
+     */
+    struct TlsfLayout
+    {
+        // Suitable for any fundamental type, and leaves bit 0 of sizes free.
+        static constexpr size_t FUNDAMENTAL = alignof(long double) > alignof(long long) ? alignof(long double) : alignof(long long);
+        static constexpr size_t ALIGNMENT = FUNDAMENTAL > 2 ? FUNDAMENTAL : 2;
+
+        static constexpr size_t HEADER = (offsetof(TlsfBlock, next_free) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        static constexpr size_t LINKS = (sizeof(TlsfBlock) - HEADER + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        static constexpr size_t MIN_PAYLOAD = LINKS > ALIGNMENT ? LINKS : ALIGNMENT;
+
+        // Second level: 8 lists per power of two. First level: one range
+        // for all sizes below SMALL, then one per power of two.
+        static constexpr uint8_t SL_LOG2 = 3;
+        static constexpr uint8_t SL_COUNT = 1 << SL_LOG2;
+        static constexpr uint8_t FL_SHIFT = SL_LOG2 + floor_log2(ALIGNMENT);
+        static constexpr size_t SMALL = static_cast<size_t>(1) << FL_SHIFT;
+    };
+
+    /**
+     * Real-time allocator over an embedded region of Size bytes. Blocks
+     * never waste more than one eighth of their size to rounding, plus a
+     * header of two words.
+     * EXAMPLE: static Tlsf<4096> heap;
+     *          void* memory = heap.allocate(24);
+     *          heap.deallocate(memory);
+     * CAUTION: not synchronized. Mask interrupts around calls shared with
+     *          ISRs, as the default heap does (see Heap.hpp).
+     * @param Size of the region in bytes, headers included.
+     */
+    template<size_t Size>
+    class Tlsf final
+    {
+    public:
+        /**
+         * Alignment of every block, suitable for any fundamental type.
+         */
+        static constexpr size_t ALIGNMENT = TlsfLayout::ALIGNMENT;
+
+        /**
+         * Initializes this Tlsf with the whole region free.
+         */
+        Tlsf(void)
+        {
+            auto first = reinterpret_cast<Block*>(_memory);
+            first->previous = nullptr;
+            first->size = (REGION - 2 * HEADER) | FREE;
+
+            // Sentinel, never free, so that the last block is never merged
+            // past the end of the region.
+            auto last = next_of(first);
+            last->previous = first;
+            last->size = 0;
+
+            insert(first);
+        }
+
+        Tlsf(const Tlsf<Size>& other) = delete;
+        Tlsf<Size>& operator =(const Tlsf<Size>& other) = delete;
+
+        /**
+         * Reserves memory in constant time.
+         * @param size in bytes.
+         * @return memory aligned on ALIGNMENT, or nullptr if no free block
+         *         is large enough.
+         */
+        void* allocate(size_t size)
+        {
+            if (size > REGION)
+            {
+                return nullptr;
+            }
+
+            auto needed = size < MIN_PAYLOAD ? MIN_PAYLOAD : (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+            // Any block of the next list up is large enough: no list is
+            // ever searched.
+            auto wanted = needed;
+            if (wanted >= SMALL)
+            {
+                wanted += (static_cast<size_t>(1) << (last_bit(wanted) - SL_LOG2)) - 1;
+            }
+
+            uint8_t fl;
+            uint8_t sl;
+            map(wanted, fl, sl);
+            auto block = fl < FL_COUNT ? find(fl, sl) : nullptr;
+            if (block == nullptr)
+            {
+                // Still constant time: the first block of the list of
+                // needed itself may be large enough.
+                map(needed, fl, sl);
+                block = _heads[fl][sl];
+                if (block == nullptr || size_of(block) < needed)
+                {
+                    return nullptr;
+                }
+            }
+
+            remove(block);
+            split(block, needed);
+            block->size = size_of(block);
+            _used += HEADER + size_of(block);
+            return reinterpret_cast<unsigned char*>(block) + HEADER;
+        }
+
+        /**
+         * Gives memory back in constant time, merging it with the adjacent
+         * free blocks.
+         * @param memory returned by allocate() on this Tlsf, or nullptr.
+         */
+        void deallocate(void* memory)
+        {
+            if (memory == nullptr)
+            {
+                return;
+            }
+
+            auto block = reinterpret_cast<Block*>(static_cast<unsigned char*>(memory) - HEADER);
+            _used -= HEADER + size_of(block);
+
+            auto previous = block->previous;
+            if (previous != nullptr && is_free(previous))
+            {
+                remove(previous);
+                previous->size = size_of(previous) + HEADER + size_of(block);
+                block = previous;
+                next_of(block)->previous = block;
+            }
+
+            auto next = next_of(block);
+            if (is_free(next))
+            {
+                remove(next);
+                block->size = size_of(block) + HEADER + size_of(next);
+                next_of(block)->previous = block;
+            }
+
+            block->size |= FREE;
+            insert(block);
+        }
+
+        /**
+         * Allocator interface of allocate_unique and allocate_shared.
+         * @param size in bytes.
+         * @param alignment of the memory. Must not exceed ALIGNMENT.
+         * @return the memory, or nullptr if no free block is large enough.
+         */
+        void* allocate(size_t size, size_t alignment)
+        {
+            return alignment <= ALIGNMENT ? allocate(size) : nullptr;
+        }
+
+        /**
+         * Allocator interface of allocate_unique and allocate_shared.
+         * @param memory returned by allocate() on this Tlsf, or nullptr.
+         */
+        void deallocate(void* memory, size_t)
+        {
+            deallocate(memory);
+        }
+
+        /**
+         * @return true if memory lies in the region of this Tlsf.
+         */
+        bool owns(const void* memory) const noexcept
+        {
+            auto address = reinterpret_cast<uintptr_t>(memory);
+            auto start = reinterpret_cast<uintptr_t>(_memory);
+            return address >= start && address < start + Size;
+        }
+
+        /**
+         * @return the number of bytes currently allocated, headers and
+         *         rounding included.
+         */
+        size_t used(void) const noexcept
+        {
+            return _used;
+        }
+
+        /**
+         * @return the size of the region, in bytes.
+         */
+        constexpr size_t capacity(void) const noexcept
+        {
+            return Size;
+        }
+
+    private:
+        using Block = TlsfBlock;
+
+        static constexpr size_t FREE = 1;
+        static constexpr size_t HEADER = TlsfLayout::HEADER;
+        static constexpr size_t MIN_PAYLOAD = TlsfLayout::MIN_PAYLOAD;
+        static constexpr uint8_t SL_LOG2 = TlsfLayout::SL_LOG2;
+        static constexpr uint8_t SL_COUNT = TlsfLayout::SL_COUNT;
+        static constexpr uint8_t FL_SHIFT = TlsfLayout::FL_SHIFT;
+        static constexpr size_t SMALL = TlsfLayout::SMALL;
+        static constexpr size_t REGION = Size & ~(ALIGNMENT - 1);
+        static constexpr uint8_t FL_COUNT = floor_log2(Size) >= FL_SHIFT ? floor_log2(Size) - FL_SHIFT + 2 : 1;
+
+        static_assert(Size >= 2 * HEADER + MIN_PAYLOAD + ALIGNMENT, "Tlsf region too small");
+        static_assert(FL_COUNT < 32, "Tlsf region too large");
+
+        alignas(ALIGNMENT) unsigned char _memory[Size];
+        Block* _heads[FL_COUNT][SL_COUNT]{ };
+        uint32_t _fl_map{ };
+        uint8_t _sl_map[FL_COUNT]{ };
+        size_t _used{ };
+
+        static size_t size_of(const Block* block)
+        {
+            return block->size & ~FREE;
+        }
+
+        static bool is_free(const Block* block)
+        {
+            return (block->size & FREE) != 0;
+        }
+
+        static Block* next_of(Block* block)
+        {
+            return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(block) + HEADER + size_of(block));
+        }
+
+        // Index of the highest set bit. CLZ instruction on ARM, bounded
+        // loop in libgcc on AVR.
+        static uint8_t last_bit(size_t value)
+        {
+            return static_cast<uint8_t>(sizeof(unsigned long) * 8 - 1 - __builtin_clzl(value));
+        }
+
+        static uint8_t first_bit(uint32_t value)
+        {
+            return static_cast<uint8_t>(__builtin_ctzl(value));
+        }
+
+        // Finds the list holding blocks of size bytes.
+        static void map(size_t size, uint8_t& fl, uint8_t& sl)
+        {
+            if (size < SMALL)
+            {
+                fl = 0;
+                sl = static_cast<uint8_t>(size >> floor_log2(ALIGNMENT));
+            }
+            else
+            {
+                auto bit = last_bit(size);
+                sl = static_cast<uint8_t>((size >> (bit - SL_LOG2)) ^ SL_COUNT);
+                fl = bit - FL_SHIFT + 1;
+            }
+        }
+
+        // First non empty list at (fl, sl) or above.
+        Block* find(uint8_t fl, uint8_t sl)
+        {
+            uint8_t sl_map = _sl_map[fl] & static_cast<uint8_t>(0xFF << sl);
+            if (sl_map == 0)
+            {
+                auto fl_map = _fl_map & (~static_cast<uint32_t>(0) << (fl + 1));
+                if (fl_map == 0)
+                {
+                    return nullptr;
+                }
+
+                fl = first_bit(fl_map);
+                sl_map = _sl_map[fl];
+            }
+
+            return _heads[fl][first_bit(sl_map)];
+        }
+
+        void insert(Block* block)
+        {
+            uint8_t fl;
+            uint8_t sl;
+            map(size_of(block), fl, sl);
+
+            auto& head = _heads[fl][sl];
+            block->next_free = head;
+            block->previous_free = nullptr;
+            if (head != nullptr)
+            {
+                head->previous_free = block;
+            }
+            head = block;
+
+            _sl_map[fl] |= static_cast<uint8_t>(1 << sl);
+            _fl_map |= static_cast<uint32_t>(1) << fl;
+        }
+
+        void remove(Block* block)
+        {
+            uint8_t fl;
+            uint8_t sl;
+            map(size_of(block), fl, sl);
+
+            if (block->next_free != nullptr)
+            {
+                block->next_free->previous_free = block->previous_free;
+            }
+
+            if (block->previous_free != nullptr)
+            {
+                block->previous_free->next_free = block->next_free;
+            }
+            else
+            {
+                _heads[fl][sl] = block->next_free;
+                if (block->next_free == nullptr)
+                {
+                    _sl_map[fl] &= static_cast<uint8_t>(~(1 << sl));
+                    if (_sl_map[fl] == 0)
+                    {
+                        _fl_map &= ~(static_cast<uint32_t>(1) << fl);
+                    }
+                }
+            }
+        }
+
+        // Gives the end of block back if it can hold another block.
+        void split(Block* block, size_t needed)
+        {
+            auto size = size_of(block);
+            if (size < needed + HEADER + MIN_PAYLOAD)
+            {
+                return;
+            }
+
+            auto rest = reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(block) + HEADER + needed);
+            rest->previous = block;
+            rest->size = (size - needed - HEADER) | FREE;
+            next_of(rest)->previous = rest;
+            block->size = needed | (block->size & FREE);
+            insert(rest);
+        }
+    };
+}
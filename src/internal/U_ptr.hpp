@@ -15,86 +15,239 @@
  *  Description:
  *    Like std::unique_ptr, U_ptr changes ownership on new assignment.
  *    The object pointed to is destroyed whenever the U_ptr goes out of
- *    scope. U_ptr does not allow copying.
+ *    scope. U_ptr does not allow copying. A custom deleter can replace
+ *    the default delete, e.g. to return the object to an ObjectPool.
  *
  ******************************************************************************
  */
 #pragma once
 #include "SmartPointer.hpp"
+#include "DefaultDelete.hpp"
+#include "Heap.hpp"
+#include "Instrumentation.hpp"
+#include "Utility.hpp"
 
 namespace DuinoMemory
 {
+    /**
+     * Storage for the deleter of a U_ptr. Class deleters are inherited
+     * from, so that stateless ones take no room (empty base optimization);
+     * function pointers and final classes are stored as a member.
+     * @param Deleter class or function pointer type.
+     */
+    template<typename Deleter, bool IsBase = __is_class(Deleter) && !__is_final(Deleter)>
+    class DeleterHolder : private Deleter
+    {
+    protected:
+        DeleterHolder(void) = default;
+
+        explicit DeleterHolder(Deleter deleter) : Deleter{ DuinoMemory::move(deleter) }
+        {
+            // Empty body
+        }
+
+        Deleter& deleter(void) noexcept
+        {
+            return *this;
+        }
+
+        const Deleter& deleter(void) const noexcept
+        {
+            return *this;
+        }
+    };
+
+    template<typename Deleter>
+    class DeleterHolder<Deleter, false>
+    {
+    protected:
+        DeleterHolder(void) = default;
+
+        explicit DeleterHolder(Deleter deleter) : _deleter{ DuinoMemory::move(deleter) }
+        {
+            // Empty body
+        }
+
+        Deleter& deleter(void) noexcept
+        {
+            return _deleter;
+        }
+
+        const Deleter& deleter(void) const noexcept
+        {
+            return _deleter;
+        }
+
+    private:
+        Deleter _deleter{ };
+    };
+
+    template<typename T, size_t N, typename Deleter>
+    class SpscQueue;
+
     /**
      * Pointer wrapper that automatically deallocates memory
      * when destroyed. U_ptr does not allow copying; ownership is transferred
      * on each assignment.
-     * @param T can be of any type. CAUTION: as a base type, T must have a virtual
-     *        destructor, otherwise deleting the base pointer may lead to
-     *        undefined behavior and cause memory leaks or crashes.
+     * @param T can be of any type, or an array such as int[]. CAUTION: as
+     *        a base type, T must have a virtual destructor, otherwise
+     *        deleting the base pointer may lead to undefined behavior and
+     *        cause memory leaks or crashes.
+     * @param Deleter callable destroying a non null T* (element pointer for
+     *        arrays, destroyed with delete[] by default): either a class,
+     *        or a function pointer such as void (*)(T*). Stateless classes
+     *        do not increase the size of U_ptr, function pointers add one
+     *        pointer.
      */
-    template<typename T>
-    class U_ptr final : public SmartPointer<T>
+    template<typename T, typename Deleter = DefaultDelete<T>>
+    class U_ptr final : public SmartPointer<T>, private DeleterHolder<Deleter>
     {
+        template<typename, typename>
+        friend class U_ptr;
+
+        template<typename, size_t, typename>
+        friend class SpscQueue;
+
+        // Enables an overload only if U_ptr<U, E> can be moved to this type.
+        template<typename U, typename E>
+        using if_compatible = typename enable_if<is_convertible<U*, T*>::value && is_convertible<E, Deleter>::value>::type;
+
     public:
+        using element_type = typename SmartPointer<T>::element_type;
+
+        /**
+         * Initializes this U_ptr as the nullptr. Not available with a
+         * function pointer Deleter, which would be null.
+         */
+        U_ptr(void) noexcept : SmartPointer<T>{ }
+        {
+            static_assert(!is_pointer<Deleter>::value, "U_ptr with a function pointer deleter must be given the deleter: U_ptr(data, deleter)");
+        }
+
         /**
-         * Initializes this U_ptr as the nullptr.
+         * Initializes this U_ptr with the provided data pointer. Not
+         * available with a function pointer Deleter, which would be null.
+         * @param data can be nullptr.
          */
-        U_ptr(void) = default;
+        explicit U_ptr(element_type* data) : SmartPointer<T>{ data }
+        {
+            static_assert(!is_pointer<Deleter>::value, "U_ptr with a function pointer deleter must be given the deleter: U_ptr(data, deleter)");
+            track_take(data);
+        }
+
+        // Arrays cannot be deleted through a pointer to a base type of
+        // their elements.
+        template<typename U, typename = typename enable_if<is_array<T>::value && is_convertible<U*, element_type*>::value>::type>
+        explicit U_ptr(U* data) = delete;
 
         /**
-         * Initializes this U_ptr with the provided data pointer.
+         * Initializes this U_ptr with the provided data pointer and the
+         * deleter in charge of destroying it.
+         * EXAMPLE: U_ptr<File, void (*)(File*)> file{ open_file(), &close_file };
          * @param data can be nullptr.
+         * @param deleter must be able to destroy data. The only way to
+         *        adopt data when Deleter is a function pointer type.
          */
-        explicit U_ptr(T* data) : SmartPointer<T>{ data }
+        U_ptr(element_type* data, Deleter deleter) : SmartPointer<T>{ data }, DeleterHolder<Deleter>{ DuinoMemory::move(deleter) }
         {
-            // Empty body.
+            track_take(data);
         }
 
-        U_ptr(const U_ptr<T>& other) = delete;
+        U_ptr(const U_ptr<T, Deleter>& other) = delete;
 
-        U_ptr(U_ptr<T>&& other) noexcept : SmartPointer<T>{ nullptr }
+        U_ptr(U_ptr<T, Deleter>&& other) noexcept
+            : SmartPointer<T>{ nullptr }, DeleterHolder<Deleter>{ DuinoMemory::move(other.get_deleter()) }
         {
             SmartPointer<T>::set_data(other.get());
             other.set_data(nullptr);
         }
 
+        /**
+         * Takes over the object owned by other, a U_ptr to a derived type,
+         * along with its deleter. other is left null.
+         * EXAMPLE: U_ptr<Device> device = make_unique<Sensor>();
+         * @param U type whose pointers convert to T*.
+         * @param E deleter type convertible to Deleter.
+         */
+        template<typename U, typename E, typename = if_compatible<U, E>>
+        U_ptr(U_ptr<U, E>&& other) noexcept
+            : SmartPointer<T>{ nullptr }, DeleterHolder<Deleter>{ DuinoMemory::move(other.get_deleter()) }
+        {
+            auto data = other.detach();
+            SmartPointer<T>::set_data(data);
+            track_move<U, E>(data);
+        }
+
         // Automatically destroys data when out of scope.
         ~U_ptr(void)
         {
-            delete SmartPointer<T>::get();
+            destroy(SmartPointer<T>::get());
         }
 
         /**
          * Abandons ownership of the pointed object.
          * @return the raw pointer to the object.
          */
-        T* release(void)
+        element_type* release(void)
         {
             auto ptr = SmartPointer<T>::get();
             SmartPointer<T>::set_data(nullptr);
+            track_drop(ptr);
             return ptr;
         }
 
         /**
+         * @return the deleter in charge of destroying the pointed object.
+         */
+        Deleter& get_deleter(void) noexcept
+        {
+            return DeleterHolder<Deleter>::deleter();
+        }
+
+        const Deleter& get_deleter(void) const noexcept
+        {
+            return DeleterHolder<Deleter>::deleter();
+        }
+
+        /**
+         * Not available with a function pointer Deleter: assign a U_ptr
+         * built with its deleter instead.
          * CAUTION: Assigning a raw pointer transfers ownership.
-         *          The pointer must not be owned elsewhere.
+         *          The pointer must not be owned elsewhere, and must be
+         *          destroyable by Deleter.
          */
-        U_ptr<T>& operator =(T* data_ptr)
+        U_ptr<T, Deleter>& operator =(element_type* data_ptr)
         {
+            static_assert(!is_pointer<Deleter>::value, "U_ptr with a function pointer deleter must be given the deleter: U_ptr(data, deleter)");
             auto tmp = SmartPointer<T>::get();
             // Avoid self assignment.
             if (data_ptr != tmp)
             {
-                delete tmp;
+                destroy(tmp);
                 SmartPointer<T>::set_data(data_ptr);
+                track_take(data_ptr);
             }
 
             return *this;
         }
 
-        U_ptr<T>& operator =(const U_ptr<T>& other) = delete;
+        /**
+         * Destroys the current object, if any. The deleter is kept.
+         */
+        U_ptr<T, Deleter>& operator =(decltype(nullptr))
+        {
+            destroy(SmartPointer<T>::get());
+            SmartPointer<T>::set_data(nullptr);
+            return *this;
+        }
+
+        // See the array constructor above.
+        template<typename U, typename = typename enable_if<is_array<T>::value && is_convertible<U*, element_type*>::value>::type>
+        U_ptr<T, Deleter>& operator =(U* data_ptr) = delete;
 
-        U_ptr<T>& operator =(U_ptr<T>&& other) noexcept
+        U_ptr<T, Deleter>& operator =(const U_ptr<T, Deleter>& other) = delete;
+
+        U_ptr<T, Deleter>& operator =(U_ptr<T, Deleter>&& other) noexcept
         {
             // Avoid self assignment.
             if (this == &other)
@@ -102,11 +255,108 @@ namespace DuinoMemory
                 return *this;
             }
 
-            delete SmartPointer<T>::get();
+            destroy(SmartPointer<T>::get());
             SmartPointer<T>::set_data(other.get());
+            get_deleter() = DuinoMemory::move(other.get_deleter());
             other.set_data(nullptr);
             return *this;
         }
+
+        /**
+         * Destroys the current object and takes over the one owned by
+         * other, a U_ptr to a derived type, along with its deleter.
+         * @param U type whose pointers convert to T*.
+         * @param E deleter type convertible to Deleter.
+         */
+        template<typename U, typename E, typename = if_compatible<U, E>>
+        U_ptr<T, Deleter>& operator =(U_ptr<U, E>&& other) noexcept
+        {
+            // Distinct types: other cannot be this.
+            auto data = other.detach();
+            destroy(SmartPointer<T>::get());
+            SmartPointer<T>::set_data(data);
+            track_move<U, E>(data);
+            get_deleter() = DuinoMemory::move(other.get_deleter());
+            return *this;
+        }
+
+    private:
+        // Marks ownership transfers that are not new allocations.
+        struct Untracked
+        {
+        };
+
+        /**
+         * Takes over data, which is already counted by the instrumentation.
+         * Reserved to ownership transfers, e.g. through a SpscQueue.
+         */
+        U_ptr(element_type* data, Untracked) : SmartPointer<T>{ data }
+        {
+            // Empty body
+        }
+
+        // Same as release(), leaving data counted by the instrumentation.
+        element_type* detach(void)
+        {
+            auto ptr = SmartPointer<T>::get();
+            SmartPointer<T>::set_data(nullptr);
+            return ptr;
+        }
+
+        void destroy(element_type* data)
+        {
+            if (data != nullptr)
+            {
+                track_drop(data);
+                get_deleter()(data);
+            }
+        }
+
+        // Only heap objects, destroyed by DefaultDelete, are counted by
+        // the instrumentation (see Instrumentation.hpp).
+        static constexpr bool tracked(void)
+        {
+            return is_same<Deleter, DefaultDelete<T>>::value;
+        }
+
+        static void track_take(element_type* data)
+        {
+            if (tracked() && data != nullptr)
+            {
+                record_allocation<T>(tracked_size<T>::value);
+            }
+        }
+
+        static void track_drop(element_type* data)
+        {
+            if (tracked() && data != nullptr)
+            {
+                record_release<T>(tracked_size<T>::value);
+            }
+        }
+
+        // data was taken from a U_ptr<U, E>: moves it to the statistics of T.
+        template<typename U, typename E>
+        static void track_move(element_type* data)
+        {
+            if (data == nullptr)
+            {
+                return;
+            }
+
+            if (U_ptr<U, E>::tracked() && tracked())
+            {
+                record_transfer<U, T>(tracked_size<U>::value, tracked_size<T>::value);
+            }
+            else if (tracked())
+            {
+                record_allocation<T>(tracked_size<T>::value);
+            }
+            else if (U_ptr<U, E>::tracked())
+            {
+                record_release<U>(tracked_size<U>::value);
+            }
+        }
     };
 
     /**
@@ -116,9 +366,9 @@ namespace DuinoMemory
      *         instance of T.
      */
     template<typename T>
-    U_ptr<T> make_unique(void)
+    typename enable_if<!is_array<T>::value, U_ptr<T>>::type make_unique(void)
     {
-        return U_ptr<T>{ new T{ } };
+        return U_ptr<T>{ heap_new<T>() };
     }
 
     /**
@@ -130,9 +380,23 @@ namespace DuinoMemory
      * @return a new instance of U_ptr<T> wrapping the instanced object.
      */
     template<typename T, class... Args>
-    U_ptr<T> make_unique(Args&&... args)
+    typename enable_if<!is_array<T>::value, U_ptr<T>>::type make_unique(Args&&... args)
+    {
+        return U_ptr<T>{ heap_new<T>(DuinoMemory::forward<Args>(args)...) };
+    }
+
+    /**
+     * Creates an array of size value initialized elements (zeros for
+     * arithmetic types), in a single allocation.
+     * EXAMPLE: U_ptr<int16_t[]> samples = make_unique<int16_t[]>(64);
+     * @param T array type, such as int16_t[].
+     * @param size number of elements.
+     * @return a new U_ptr<T> owning the array, destroyed with delete[].
+     */
+    template<typename T>
+    typename enable_if<is_array<T>::value, U_ptr<T>>::type make_unique(size_t size)
     {
-        return U_ptr<T>{ new T(args...) };
+        return U_ptr<T>{ new typename remove_extent<T>::type[size]() };
     }
 
     /**
@@ -147,7 +411,7 @@ namespace DuinoMemory
     template<typename T, typename U>
     U_ptr<T> make_unique(void)
     {
-        return U_ptr<T>{ new U{ } };
+        return U_ptr<T>{ heap_new<U>() };
     }
 
     /**
@@ -164,6 +428,6 @@ namespace DuinoMemory
     template<typename T, typename U, class... Args>
     U_ptr<T> make_unique(Args&&... args)
     {
-        return U_ptr<T>{ new U(args...) };
+        return U_ptr<T>{ heap_new<U>(DuinoMemory::forward<Args>(args)...) };
     }
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+/*
+ ******************************************************************************
+ *  Utility.hpp
+ *
+ *  Minimal move semantics and type traits helpers for DuinoMemory.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Some targets, like AVR, do not provide the <utility> and <type_traits>
+ *    headers. This file defines the equivalents of std::move and
+ *    std::forward used by the factories, so that arguments are never copied
+ *    needlessly, and the few traits needed to constrain conversions.
+ *
+ ******************************************************************************
+ */
+#pragma once
+
+namespace DuinoMemory
+{
+    /**
+     * Strips references from T, like std::remove_reference.
+     */
+    template<typename T>
+    struct remove_reference
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_reference<T&>
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_reference<T&&>
+    {
+        using type = T;
+    };
+
+    /**
+     * Casts value to an rvalue so that it can be moved from, like std::move.
+     * @param value to move from. Must not be used afterwards unless reassigned.
+     * @return value as an rvalue reference.
+     */
+    template<typename T>
+    constexpr typename remove_reference<T>::type&& move(T&& value) noexcept
+    {
+        return static_cast<typename remove_reference<T>::type&&>(value);
+    }
+
+    /**
+     * Passes a forwarding reference on with its original value category,
+     * like std::forward.
+     * EXAMPLE: template<class... Args> void f(Args&&... args)
+     *          {
+     *              g(DuinoMemory::forward<Args>(args)...);
+     *          }
+     */
+    template<typename T>
+    constexpr T&& forward(typename remove_reference<T>::type& value) noexcept
+    {
+        return static_cast<T&&>(value);
+    }
+
+    template<typename T>
+    constexpr T&& forward(typename remove_reference<T>::type&& value) noexcept
+    {
+        return static_cast<T&&>(value);
+    }
+
+    /**
+     * Defines type as T only if Condition holds, like std::enable_if.
+     * Used to remove overloads that do not apply.
+     */
+    template<bool Condition, typename T = void>
+    struct enable_if
+    {
+        // Empty body
+    };
+
+    template<typename T>
+    struct enable_if<true, T>
+    {
+        using type = T;
+    };
+
+    /**
+     * Tells whether From implicitly converts to To, like std::is_convertible.
+     * EXAMPLE: is_convertible<Derived*, Base*>::value  ==> true
+     */
+    template<typename From, typename To>
+    struct is_convertible
+    {
+    private:
+        static char test(To);
+        static long test(...);
+        static From make(void);
+
+    public:
+        static constexpr bool value = sizeof(test(make())) == sizeof(char);
+    };
+
+    /**
+     * Element type of an array type, or T itself, like std::remove_extent.
+     * EXAMPLE: remove_extent<int[]>::type  ==> int
+     */
+    template<typename T>
+    struct remove_extent
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_extent<T[]>
+    {
+        using type = T;
+    };
+
+    /**
+     * Tells whether T is an array of unknown bound, such as int[].
+     * Arrays of known bound are not supported by smart pointers.
+     */
+    template<typename T>
+    struct is_array
+    {
+        static constexpr bool value = false;
+    };
+
+    template<typename T>
+    struct is_array<T[]>
+    {
+        static constexpr bool value = true;
+    };
+
+    /**
+     * Tells whether T is a pointer type, like std::is_pointer.
+     * EXAMPLE: is_pointer<void (*)(File*)>::value  ==> true
+     */
+    template<typename T>
+    struct is_pointer
+    {
+        static constexpr bool value = false;
+    };
+
+    template<typename T>
+    struct is_pointer<T*>
+    {
+        static constexpr bool value = true;
+    };
+
+    /**
+     * Tells whether T and U are the same type, like std::is_same.
+     */
+    template<typename T, typename U>
+    struct is_same
+    {
+        static constexpr bool value = false;
+    };
+
+    template<typename T>
+    struct is_same<T, T>
+    {
+        static constexpr bool value = true;
+    };
+}
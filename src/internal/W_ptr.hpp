@@ -0,0 +1,181 @@
+/*
+ ******************************************************************************
+ *  W_ptr.hpp
+ *
+ *  Weak pointer for Arduino.
+ *
+ *  Author: Pierre DEBAS
+ *  Copyright (c) 2026
+ *
+ *  MIT License
+ *  https://github.com/Pierrolefou881/DuinoMemory
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Description:
+ *    Lightweight weak pointer similar to the STL std::weak_ptr.
+ *    Observes an object owned by S_ptr without keeping it alive, which
+ *    breaks reference cycles (parent back-links, observer lists...).
+ *    Access to the object goes through lock(), which returns a S_ptr.
+ *
+ ******************************************************************************
+ */
+#pragma once
+#include "S_ptr.hpp"
+#include <stddef.h>
+
+namespace DuinoMemory
+{
+    /**
+     * Non owning reference to an object managed by S_ptr. The object is
+     * destroyed when its last S_ptr goes away, even if W_ptr remain; the
+     * control block is freed once the last W_ptr is gone as well.
+     * @param T can be any type, or an array type like S_ptr.
+     * @param Count unsigned integer type of the reference counts. Must
+     *        match the one of the observed S_ptr.
+     * @param Lock policy protecting reference count updates. Must match the
+     *        one of the observed S_ptr.
+     */
+    template<typename T, typename Count = typename SharedTraits<T>::count_type, typename Lock = typename SharedTraits<T>::lock_type>
+    class W_ptr final
+    {
+    public:
+        /**
+         * Initializes this W_ptr as expired.
+         */
+        W_ptr(void) = default;
+
+        /**
+         * Initializes this W_ptr observing the object owned by shared.
+         * @param shared can be nullptr.
+         */
+        W_ptr(const S_ptr<T, Count, Lock>& shared) : _data{ shared.get() }, _control{ shared._control }
+        {
+            if (_control != nullptr)
+            {
+                _control->acquire_weak();
+            }
+        }
+
+        W_ptr(const W_ptr<T, Count, Lock>& other) : _data{ other._data }, _control{ other._control }
+        {
+            if (_control != nullptr)
+            {
+                _control->acquire_weak();
+            }
+        }
+
+        W_ptr(W_ptr<T, Count, Lock>&& other) noexcept : _data{ other._data }, _control{ other._control }
+        {
+            other._data = nullptr;
+            other._control = nullptr;
+        }
+
+        ~W_ptr(void)
+        {
+            release();
+        }
+
+        /**
+         * @return the number of S_ptr owning the observed object, 0 if
+         *         it has been destroyed.
+         */
+        size_t count(void) const noexcept
+        {
+            return _control != nullptr ? _control->count() : 0;
+        }
+
+        /**
+         * @return true if the observed object has been destroyed, or if
+         *         this W_ptr never observed any.
+         */
+        bool expired(void) const noexcept
+        {
+            return count() == 0;
+        }
+
+        /**
+         * Gives temporary shared ownership of the observed object.
+         * EXAMPLE: auto parent = _parent.lock();
+         *          if (parent) { parent->notify(); }
+         * @return a S_ptr to the observed object, or nullptr if expired.
+         */
+        S_ptr<T, Count, Lock> lock(void) const
+        {
+            if (_control != nullptr && _control->try_acquire())
+            {
+                return S_ptr<T, Count, Lock>{ _data, _control };
+            }
+            return S_ptr<T, Count, Lock>{ };
+        }
+
+        /**
+         * Stops observing the current object.
+         */
+        void reset(void)
+        {
+            release();
+        }
+
+        W_ptr<T, Count, Lock>& operator =(const S_ptr<T, Count, Lock>& shared)
+        {
+            // Aliasing S_ptr share a block but not their address.
+            if (shared._control != _control)
+            {
+                release();
+                _control = shared._control;
+                if (_control != nullptr)
+                {
+                    _control->acquire_weak();
+                }
+            }
+            _data = shared.get();
+            return *this;
+        }
+
+        W_ptr<T, Count, Lock>& operator =(const W_ptr<T, Count, Lock>& other)
+        {
+            if (this != &other)
+            {
+                if (other._control != nullptr)
+                {
+                    other._control->acquire_weak();
+                }
+                release();
+                _data = other._data;
+                _control = other._control;
+            }
+            return *this;
+        }
+
+        W_ptr<T, Count, Lock>& operator =(W_ptr<T, Count, Lock>&& other) noexcept
+        {
+            // Avoid self assignment.
+            if (this != &other)
+            {
+                release();
+                _data = other._data;
+                _control = other._control;
+                other._data = nullptr;
+                other._control = nullptr;
+            }
+            return *this;
+        }
+
+    private:
+        // Never dereferenced directly: may dangle once expired.
+        typename remove_extent<T>::type* _data{ };
+        ControlBlock<Count, Lock>* _control{ };
+
+        void release(void)
+        {
+            if (_control != nullptr)
+            {
+                _control->release_weak();
+            }
+
+            _data = nullptr;
+            _control = nullptr;
+        }
+    };
+}